@@ -0,0 +1,66 @@
+#ifndef ADMISSION_CONTROL_H
+#define ADMISSION_CONTROL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace QualityManagement {
+
+// 准入控制：按接口和数据规模估算每个请求的计算代价，
+// 已接纳（排队加执行中）请求的总代价超过预算时直接拒绝新请求，
+// 让已接纳请求的延迟保持有界，而不是所有请求一起变慢。所有Reactor共享一个实例
+class AdmissionController {
+public:
+    // budget为总代价上限（单位：样本点），0表示不限制
+    explicit AdmissionController(uint64_t budget);
+
+    // 估算请求代价：固定开销加上接口权重乘以涉及的样本点数。分析接口涉及现有数据集的
+    // sampleCount个样本点；/generate-data涉及请求要求生成的requestedSamples个，与现有数据无关
+    static uint64_t estimateCost(std::string_view path, size_t bodySize, size_t sampleCount,
+                                 uint64_t requestedSamples = 0);
+
+    // 尝试接纳一个请求并占用预算；当前没有已接纳请求时总是接纳，超大请求不会永远被拒绝
+    bool tryAdmit(uint64_t cost);
+
+    // 请求执行结束，归还预算
+    void release(uint64_t cost);
+
+    // 记录一次因其他原因（如任务队列已满）被拒绝的请求
+    void recordShed() { shed_.fetch_add(1, std::memory_order_relaxed); }
+
+    // 建议客户端在多少秒后重试，随超载程度增长
+    int retryAfterSeconds() const;
+
+    uint64_t budget() const { return budget_; }
+    uint64_t inFlightCost() const { return inFlight_.load(std::memory_order_relaxed); }
+    uint64_t admittedCount() const { return admitted_.load(std::memory_order_relaxed); }
+    uint64_t shedCount() const { return shed_.load(std::memory_order_relaxed); }
+
+private:
+    const uint64_t budget_;
+    std::atomic<uint64_t> inFlight_{0};
+    std::atomic<uint64_t> admitted_{0};
+    std::atomic<uint64_t> shed_{0};
+};
+
+// 已接纳请求占用的预算，析构时归还；随计算任务一起传递，
+// 任务正常完成、抛出异常或提交失败被丢弃时都会归还
+class AdmissionTicket {
+public:
+    AdmissionTicket(AdmissionController& controller, uint64_t cost)
+        : controller_(controller), cost_(cost) {}
+    ~AdmissionTicket() { controller_.release(cost_); }
+
+    AdmissionTicket(const AdmissionTicket&) = delete;
+    AdmissionTicket& operator=(const AdmissionTicket&) = delete;
+
+private:
+    AdmissionController& controller_;
+    const uint64_t cost_;
+};
+
+} // namespace QualityManagement
+
+#endif // ADMISSION_CONTROL_H
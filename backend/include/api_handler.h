@@ -1,38 +1,132 @@
 #ifndef API_HANDLER_H
 #define API_HANDLER_H
 
+#include <atomic>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <shared_mutex>
+#include "body_format.h"
+#include "control_chart_feed.h"
+#include "nlohmann/json.hpp"
+#include "response_sink.h"
 #include "statistics.h"
 
 namespace QualityManagement {
 
+class JsonStreamWriter;
+
 class ApiHandler {
 public:
     ApiHandler();
     ~ApiHandler();
     
-    // 处理API请求并返回JSON响应
-    std::string handleRequest(const std::string& path, const std::string& requestBody);
+    // 处理API请求并返回响应体
+    // requestBody直接引用连接接收缓冲中的数据，不做拷贝；请求体只解析一次，响应体只序列化一次；
+    // requestFormat为请求体的格式（按Content-Type确定），响应体直接按responseFormat（按Accept协商）生成
+    std::string handleRequest(const std::string& path, std::string_view requestBody,
+                              BodyFormat requestFormat = BodyFormat::Json,
+                              BodyFormat responseFormat = BodyFormat::Json);
     
-private:
-    // 数据存储
-    std::vector<std::vector<double>> data_;
+    // 以已解析的请求参数处理API请求（调用方已为其他目的解析过请求体时使用）
+    std::string handleParsedRequest(std::string_view path, const nlohmann::json& params,
+                                    BodyFormat responseFormat = BodyFormat::Json);
+    
+    // 当前数据集的样本点总数（供就绪探针和准入控制读取，不加锁）
+    size_t sampleCount() const { return sampleCount_.load(std::memory_order_acquire); }
+    bool hasData() const { return sampleCount() > 0; }
+    
+    // 数据集版本号，每次生成、导入或追加数据后递增；用于判断两次分析是否针对同一份数据
+    uint64_t dataVersion() const { return dataVersion_.load(std::memory_order_acquire); }
+    
+    // 把当前数据集写入文件（与/import-data相同的格式），先写临时文件再重命名，
+    // 进程在写入中途被终止也不会留下半个文件
+    bool saveData(const std::string& filePath) const;
+    
+    // 启动时从saveData写出的文件恢复数据集，文件不存在或格式错误时返回false
+    bool loadData(const std::string& filePath);
+    
+    // 以SAX方式解析/import-data的请求体（JSON、CBOR或MessagePack），数值直接追加到分组中，
+    // 不构建完整的JSON树；返回与/import-data相同的JSON响应
+    std::string importData(std::string_view requestBody, BodyFormat format = BodyFormat::Json);
+    
+    // /generate-data按请求参数将生成的样本点数，与现有数据集无关（供准入控制估算代价）
+    static uint64_t generatedSampleCount(const nlohmann::json& params);
+    
+    // 是否存在该POST接口
+    bool hasRoute(std::string_view path) const;
+    
+    // 只读取数据集的分析接口：结果只取决于请求参数和数据集，相同的并发请求可以合并计算
+    bool isReadOnlyRoute(std::string_view path) const;
+    
+    // 结果随数据规模增长、以分块方式流式输出的接口
+    bool isStreamingRoute(std::string_view path) const;
+    
+    // 处理流式接口，响应体边序列化边写入sink；
+    // 返回false表示输出中途停止（客户端已断开），已写出的内容不完整
+    bool handleStreamingRequest(const std::string& path, std::string_view requestBody, ResponseSink& sink,
+                                BodyFormat requestFormat = BodyFormat::Json,
+                                BodyFormat responseFormat = BodyFormat::Json);
     
-    // 统计分析工具
+    // 订阅控制图的实时更新：先投递一次当前完整控制图（snapshot事件），
+    // 之后追加子组时投递新子组和更新后的控制限（append事件），数据集被替换时重新投递snapshot
+    void subscribeControlChart(ControlChartFeed::Subscriber subscriber, ControlChartFeed::Liveness alive);
+
+    // 订阅者所在的连接关闭后调用，立即释放失效的订阅者
+    void pruneControlChartSubscribers();
+    
+private:
+    // 统计分析工具，同时持有数据集（列式存储，全部样本点只保存一份）
     std::unique_ptr<Statistics> statistics_;
     
+    // 请求由多个计算线程并发处理：分析类接口共享读取，生成/导入数据独占写入
+    mutable std::shared_mutex dataMutex_;
+    std::atomic<size_t> sampleCount_{0};
+    std::atomic<uint64_t> dataVersion_{0};
+    
+    // 控制图的实时订阅者
+    ControlChartFeed chartFeed_;
+    
+    // 数据更新后刷新样本点总数并递增数据集版本号，调用方持有写锁
+    void updateSampleCount();
+    
+    // 生成从firstGroup开始的控制图事件（firstGroup为0时是完整快照），调用方持有锁
+    std::string controlChartEvent(size_t firstGroup) const;
+    
+    // 有订阅者时投递数据变化，调用方持有写锁，保证事件顺序与数据修改顺序一致
+    void publishControlChart(size_t firstGroup);
+    
+    // 路由表项：接口路径、处理方法和接口性质；处理方法把响应体写入out，返回false表示客户端已断开；
+    // 导入类接口的请求体以SAX方式直接解析进数据集（rawHandler），不构建JSON树
+    struct Route {
+        std::string_view path;
+        bool (ApiHandler::*handler)(const nlohmann::json& params, JsonStreamWriter& out);
+        bool (ApiHandler::*rawHandler)(std::string_view requestBody, BodyFormat format, JsonStreamWriter& out);
+        bool readOnly;    // 只读取数据集
+        bool streaming;   // 支持分块流式输出
+    };
+    
+    // 按路径查找路由，不存在时返回nullptr
+    static const Route* findRoute(std::string_view path);
+    
+    // 以SAX方式解析导入格式的数据并替换整个数据集，groupCount为导入的子组数；
+    // 失败时返回false，error为错误信息
+    bool replaceData(std::string_view body, BodyFormat format, size_t& groupCount, std::string& error);
+
     // 各种API端点处理方法
-    std::string handleGenerateData(const std::string& requestBody);
-    std::string handleImportData(const std::string& requestBody);
-    std::string handleDescriptiveStats(const std::string& requestBody);
-    std::string handleNormalityTest(const std::string& requestBody);
-    std::string handleMeanTest(const std::string& requestBody);
-    std::string handleCapabilityIndices(const std::string& requestBody);
-    std::string handleControlChart(const std::string& requestBody);
-    std::string handleProcessAssessment(const std::string& requestBody);
-    std::string handleAllAnalysis(const std::string& requestBody);
+    bool handleImportData(std::string_view requestBody, BodyFormat format, JsonStreamWriter& out);
+    bool handleAppendData(std::string_view requestBody, BodyFormat format, JsonStreamWriter& out);
+    bool handleDescriptiveStats(const nlohmann::json& params, JsonStreamWriter& out);
+    bool handleNormalityTest(const nlohmann::json& params, JsonStreamWriter& out);
+    bool handleMeanTest(const nlohmann::json& params, JsonStreamWriter& out);
+    bool handleCapabilityIndices(const nlohmann::json& params, JsonStreamWriter& out);
+    bool handleControlChart(const nlohmann::json& params, JsonStreamWriter& out);
+    bool handleProcessAssessment(const nlohmann::json& params, JsonStreamWriter& out);
+    
+    // 生成数据和综合分析，结果随数据规模增长，同时用于流式和整体输出
+    bool streamGenerateData(const nlohmann::json& params, JsonStreamWriter& out);
+    bool streamAllAnalysis(const nlohmann::json& params, JsonStreamWriter& out);
 };
 
 } // namespace QualityManagement
@@ -0,0 +1,36 @@
+#ifndef BODY_FORMAT_H
+#define BODY_FORMAT_H
+
+#include <string>
+#include <string_view>
+#include "nlohmann/json.hpp"
+
+namespace QualityManagement {
+
+// 请求体和响应体的序列化格式；CBOR和MessagePack与JSON表达同一数据模型，
+// 大数值数组的体积和解析耗时都明显小于文本JSON
+enum class BodyFormat {
+    Json,
+    Cbor,
+    MessagePack
+};
+
+// 按Content-Type判断请求体格式；未提供或不认识时按JSON处理
+BodyFormat requestBodyFormat(std::string_view contentType);
+
+// 按Accept选择响应格式：明确列出application/cbor或application/msgpack且q值不低于JSON时使用，
+// 否则（包括未提供Accept或只有*/*）返回JSON
+BodyFormat negotiateBodyFormat(std::string_view accept);
+
+// 格式对应的媒体类型
+const char* mediaType(BodyFormat format);
+
+// 按格式解析请求参数，空请求体等同于空对象；格式错误时抛出nlohmann::json::exception
+nlohmann::json decodeBody(std::string_view body, BodyFormat format);
+
+// 按格式序列化一个值（错误响应等小对象）；大响应体由JsonStreamWriter直接按格式生成
+std::string encodeValue(const nlohmann::json& value, BodyFormat format);
+
+} // namespace QualityManagement
+
+#endif // BODY_FORMAT_H
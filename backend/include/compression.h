@@ -0,0 +1,47 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <string>
+#include <string_view>
+#include <zlib.h>
+
+namespace QualityManagement {
+
+// 响应体的内容编码
+enum class ContentEncoding {
+    Identity,
+    Gzip,
+    Deflate       // HTTP中的deflate指zlib格式（RFC 1950），不是裸deflate流
+};
+
+// 按Accept-Encoding选择编码：优先gzip，其次deflate，q=0表示拒绝；未提供时不压缩
+ContentEncoding negotiateEncoding(std::string_view acceptEncoding);
+
+// 压缩后响应需要附加的响应头行（含CRLF）；Vary由renderVaryHeader统一给出
+std::string contentEncodingHeader(ContentEncoding encoding);
+
+// 增量压缩器：流式响应的各段依次送入，输出可以立即作为分块发送。
+// 每个压缩器只在一个线程中使用
+class Compressor {
+public:
+    Compressor(ContentEncoding encoding, int level);
+    ~Compressor();
+
+    Compressor(const Compressor&) = delete;
+    Compressor& operator=(const Compressor&) = delete;
+
+    // 压缩input并把得到的输出追加到output；finish为true时结束压缩流。
+    // zlib内部会缓存尚不足以输出的数据，一次调用可能没有任何输出
+    void compress(std::string_view input, bool finish, std::string& output);
+
+private:
+    z_stream stream_{};
+    bool finished_ = false;
+};
+
+// 整体压缩一个响应体
+std::string compressBody(std::string_view body, ContentEncoding encoding, int level);
+
+} // namespace QualityManagement
+
+#endif // COMPRESSION_H
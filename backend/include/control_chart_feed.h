@@ -0,0 +1,49 @@
+#ifndef CONTROL_CHART_FEED_H
+#define CONTROL_CHART_FEED_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace QualityManagement {
+
+// 控制图的实时订阅者（Server-Sent Events）：数据集变化时由修改数据的计算线程
+// 生成一次事件，原样投递给所有订阅者，订阅者不必反复请求完整的控制图
+class ControlChartFeed {
+public:
+    // 投递一个已编码的SSE事件；返回false表示订阅者已断开，之后不再投递
+    using Subscriber = std::function<bool(const std::string& event)>;
+
+    // 订阅者所在连接是否仍然存在，连接关闭时置为false
+    using Liveness = std::shared_ptr<const std::atomic<bool>>;
+
+    // alive已为false（连接在订阅前已关闭）时不登记
+    void subscribe(Subscriber subscriber, Liveness alive);
+
+    // 把事件投递给所有订阅者，同时移除已断开的订阅者
+    void publish(const std::string& event);
+
+    // 移除所在连接已关闭的订阅者；连接关闭时调用，数据长时间不变时也不会积累失效的订阅者
+    void prune();
+
+    bool hasSubscribers() const;
+
+    // 把一个JSON载荷编码为SSE事件（event:和data:两行，以空行结尾）
+    static std::string encodeEvent(const char* type, const std::string& data);
+
+private:
+    mutable std::mutex mutex_;
+    struct Entry {
+        Subscriber subscriber;
+        Liveness alive;
+    };
+    std::vector<Entry> subscribers_;
+};
+
+} // namespace QualityManagement
+
+#endif // CONTROL_CHART_FEED_H
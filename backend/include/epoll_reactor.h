@@ -0,0 +1,43 @@
+#ifndef EPOLL_REACTOR_H
+#define EPOLL_REACTOR_H
+
+#include "reactor.h"
+
+namespace QualityManagement {
+
+// 基于epoll边缘触发的事件循环：非阻塞套接字就绪后读写到EAGAIN，
+// 单次就绪的接收量有上限，超出时重新登记事件留到下一轮；
+// 发送缓冲区满时等待EPOLLOUT从断点继续
+class EpollReactor : public Reactor {
+public:
+    using Reactor::Reactor;
+    ~EpollReactor() override;
+
+    // 创建epoll实例和唤醒描述符
+    bool init() override;
+
+    void run() override;
+
+protected:
+    void wakeup() override;
+    void resumeConnection(Connection& conn) override;
+    void flushConnection(Connection& conn) override;
+    void closeConnection(int fd) override;
+    void discardInput(Connection& conn) override;
+    void stopAccepting() override;
+
+private:
+    int epollFd_ = -1;
+    int wakeFd_ = -1;
+
+    void handleAccept(int listenFd);
+    bool handleRead(Connection& conn);
+    bool handleWrite(Connection& conn);
+
+    // 本次就绪未读完就停止接收时调用，让epoll再次报告可读
+    void rearm(Connection& conn);
+};
+
+} // namespace QualityManagement
+
+#endif // EPOLL_REACTOR_H
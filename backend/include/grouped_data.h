@@ -0,0 +1,62 @@
+#ifndef GROUPED_DATA_H
+#define GROUPED_DATA_H
+
+#include <cstddef>
+#include <vector>
+
+namespace QualityManagement {
+
+// 一段连续样本点的只读视图，可由std::vector<double>隐式构造
+class SampleSpan {
+public:
+    SampleSpan(const double* first, const double* last) : first_(first), last_(last) {}
+    SampleSpan(const std::vector<double>& values) : first_(values.data()), last_(values.data() + values.size()) {}
+
+    const double* begin() const { return first_; }
+    const double* end() const { return last_; }
+    size_t size() const { return static_cast<size_t>(last_ - first_); }
+    bool empty() const { return first_ == last_; }
+    double operator[](size_t index) const { return first_[index]; }
+
+private:
+    const double* first_;
+    const double* last_;
+};
+
+// 分组数据的列式存储：全部样本点按子组顺序连续存放在一个数组中，另以偏移量数组记录各子组的起点。
+// 整体分析直接使用这个连续数组，不再另存扁平化副本；导入时数值逐个追加到末尾正在构建的子组
+class GroupedData {
+public:
+    size_t groupCount() const { return offsets_.size() - 1; }
+    bool empty() const { return groupCount() == 0; }
+
+    // 已完成子组的样本点总数
+    size_t size() const { return offsets_.back(); }
+
+    // 第index个子组
+    SampleSpan group(size_t index) const {
+        return SampleSpan(values_.data() + offsets_[index], values_.data() + offsets_[index + 1]);
+    }
+
+    // 全部样本点；构建子组期间不调用
+    const std::vector<double>& values() const { return values_; }
+
+    // 向正在构建的子组追加一个样本点
+    void appendValue(double value) { values_.push_back(value); }
+
+    // 结束正在构建的子组；空子组被忽略
+    void closeGroup();
+
+    // 追加一个完整的子组；空子组被忽略
+    void appendGroup(SampleSpan group);
+
+    void clear();
+
+private:
+    std::vector<double> values_;
+    std::vector<size_t> offsets_{0};
+};
+
+} // namespace QualityManagement
+
+#endif // GROUPED_DATA_H
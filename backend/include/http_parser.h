@@ -0,0 +1,98 @@
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace QualityManagement {
+
+// 已解析的HTTP请求，各字段直接引用连接接收缓冲中的数据，
+// 在请求被消费（InputBuffer::consume）之前有效
+struct HttpRequest {
+    std::string_view method;
+    std::string_view path;
+    std::string_view version;
+    std::string_view body;
+    std::string_view realIp;   // 反向代理传递的X-Real-IP，未提供时为空
+    std::string_view acceptEncoding; // 客户端接受的响应内容编码，未提供时为空
+    std::string_view contentType;    // 请求体的媒体类型，未提供时为空
+    std::string_view accept;         // 客户端接受的响应媒体类型，未提供时为空
+    size_t contentLength = 0;
+    bool keepAlive = true;     // HTTP/1.1默认保持连接
+};
+
+// 解析结果
+enum class ParseStatus {
+    Incomplete,   // 数据不足，需要继续接收
+    Complete,     // 已得到一个完整请求
+    Error         // 请求格式错误，连接应当关闭
+};
+
+// 可恢复的HTTP/1.x请求解析状态机，每个连接一个实例。
+// 每次调用只扫描上次之后新到达的字节，整个请求只经过一次线性扫描；
+// 解析进度以相对请求起点的偏移量保存，接收缓冲扩容或整理后仍然有效
+class HttpParser {
+public:
+    explicit HttpParser(size_t maxBodySize);
+
+    // data为接收缓冲中从当前请求起点开始的全部可读数据
+    ParseStatus parse(std::string_view data, HttpRequest& request);
+
+    // 请求头解析完成后整个请求（请求头加请求体）的字节数，之前为0
+    size_t requestLength() const { return state_ == State::Body ? bodyStart_ + contentLength_ : 0; }
+
+    // 请求头解析完成后请求行加请求头的字节数，之前为0
+    size_t headerLength() const { return state_ == State::Body ? bodyStart_ : 0; }
+
+    // 请求头已完整、请求体尚未到齐时取出请求行和请求头字段（body为空），
+    // 用于在接收请求体之前决定如何处理；请求头未完整时返回false
+    bool peekHeaders(std::string_view data, HttpRequest& request) const;
+
+    // 当前请求已被消费，准备解析下一个请求
+    void reset();
+
+    // 解析失败时对应的HTTP状态行和错误描述
+    const char* errorStatus() const { return errorStatus_; }
+    const std::string& errorMessage() const { return errorMessage_; }
+
+private:
+    enum class State {
+        RequestLine,   // 等待请求行
+        Headers,       // 逐行解析请求头
+        Body           // 等待Content-Length字节的请求体
+    };
+
+    // 请求行各字段在请求中的偏移量
+    struct Span {
+        size_t offset = 0;
+        size_t length = 0;
+    };
+
+    size_t maxBodySize_;
+    State state_ = State::RequestLine;
+    size_t scanOffset_ = 0;      // 下一次查找行结束符的位置
+    size_t lineStart_ = 0;       // 当前行的起点
+    Span method_;
+    Span path_;
+    Span version_;
+    Span realIp_;
+    Span acceptEncoding_;
+    Span contentType_;
+    Span accept_;
+    size_t bodyStart_ = 0;
+    size_t contentLength_ = 0;
+    bool contentLengthSeen_ = false;
+    bool keepAlive_ = true;
+    const char* errorStatus_ = "400 Bad Request";
+    std::string errorMessage_;
+
+    void fillHeaders(std::string_view data, HttpRequest& request) const;
+    bool parseRequestLine(std::string_view line);
+    bool parseHeaderLine(std::string_view line);
+    ParseStatus fail(const char* status, const std::string& message);
+};
+
+} // namespace QualityManagement
+
+#endif // HTTP_PARSER_H
@@ -0,0 +1,49 @@
+#ifndef HTTP_RESPONSE_H
+#define HTTP_RESPONSE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace QualityManagement {
+
+// HTTP响应：预先生成的响应头块与响应体分开保存，
+// 发送时用writev一次写出，不再把两者拼接成新的字符串
+struct HttpResponse {
+    std::string header;        // 状态行和全部响应头，以空行结尾
+    std::string body;          // 响应体
+    std::shared_ptr<const std::string> sharedBody; // 多个响应共享的响应体，非空时代替body
+    bool closeAfterSend = false; // 发送后关闭连接（如流式响应中途失败，只能以断开告知客户端）
+};
+
+// 生成JSON响应的状态行和响应头
+// extraHeaders为附加的完整响应头行（含CRLF），如Retry-After；按Accept协商为二进制格式时contentType随之改变
+std::string renderResponseHeader(size_t contentLength, bool keepAlive, const char* status = "200 OK",
+                                 const std::string& extraHeaders = std::string(),
+                                 const char* contentType = "application/json");
+
+// 生成分块传输（Transfer-Encoding: chunked）的响应头，响应体长度事先未知
+std::string renderChunkedHeader(bool keepAlive, const char* status = "200 OK",
+                                const std::string& extraHeaders = std::string(),
+                                const char* contentType = "application/json");
+
+// API响应的Vary头：响应格式随Accept协商；启用压缩时还随Accept-Encoding变化。
+// 两者合并为一行，缓存按同一组请求头区分响应
+std::string renderVaryHeader(bool acceptEncoding);
+
+// 生成Server-Sent Events（text/event-stream）响应头；事件流以关闭连接结束，不带长度
+std::string renderEventStreamHeader();
+
+// 生成一个分块的长度行；非首个分块在前面带上前一分块结尾的CRLF
+std::string renderChunkPrefix(size_t chunkSize, bool first);
+
+// 结束分块响应的零长度分块
+std::string renderLastChunk(bool first);
+
+// 以JSON响应体构造完整响应
+HttpResponse makeJsonResponse(std::string body, bool keepAlive, const char* status = "200 OK",
+                              const std::string& extraHeaders = std::string());
+
+} // namespace QualityManagement
+
+#endif // HTTP_RESPONSE_H
@@ -0,0 +1,105 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "admission_control.h"
+#include "job_manager.h"
+#include "api_handler.h"
+#include "rate_limiter.h"
+#include "request_coalescer.h"
+#include "thread_pool.h"
+
+namespace QualityManagement {
+
+class Reactor;
+
+// 套接字I/O后端
+enum class IoBackend {
+    Epoll,        // 就绪通知，所有Linux内核可用
+    IoUring       // 完成通知，内核不支持时回退到epoll
+};
+
+// 服务器运行参数
+struct ServerOptions {
+    int port = 3001;              // 监听端口
+    std::string bindAddress = "0.0.0.0";  // TCP监听地址
+    int ioThreads = 0;            // 事件循环线程数，0表示按CPU核心数
+    int workerThreads = 0;        // 统计计算线程数，0表示按CPU核心数
+    int workerQueueDepth = 256;   // 计算任务队列上限，超出时返回503
+    uint64_t admissionBudget = 256ull * 1000 * 1000;  // 已接纳请求的总估算代价上限（样本点），0表示不限制
+    int rateLimitRps = 0;         // 每个客户端每秒补充的令牌数，0表示不限流
+    int rateLimitBurst = 60;      // 每个客户端的令牌桶容量
+    bool reusePort = false;       // 每个Reactor使用独立的SO_REUSEPORT监听套接字并绑定CPU核心
+    IoBackend ioBackend = IoBackend::Epoll;
+    size_t maxBodySize = 1024ull * 1024 * 1024;  // 单个请求体上限，超出时返回413
+    size_t readChunkSize = 16384; // 单次接收的最大字节数，也是io_uring每个固定缓冲的大小
+    unsigned uringEntries = 4096; // io_uring提交队列槽位数
+    int uringFixedBuffers = 128;  // 每个io_uring Reactor注册的固定缓冲数
+    size_t streamBacklog = 1024 * 1024;  // 单个流式响应允许积压的最大字节数
+    int compressionLevel = 1;     // 响应gzip/deflate压缩级别（1-9），0表示不压缩；数值数组在低级别下已有很高压缩率
+    size_t compressionThreshold = 1024;  // 响应体达到该字节数才压缩
+    size_t spoolThreshold = 64ull * 1024 * 1024;  // /import-data请求体达到该大小时暂存到磁盘，0表示不暂存
+    std::string spoolDir = "/tmp"; // 暂存请求体的目录
+    int headerTimeoutMs = 10000;  // 从请求第一个字节到请求头完整的期限，0表示不限制
+    int bodyTimeoutMs = 300000;   // 请求头之后接收完整请求体的期限
+    int idleTimeoutMs = 60000;    // 长连接空闲的期限
+    int writeTimeoutMs = 30000;   // 请求计算期间有待发送的数据而客户端一直不读取的期限，0表示不限制
+    int heartbeatMs = 15000;      // 事件流连接的心跳间隔，使代理不因空闲断开，并及时发现已断开的客户端
+    std::string unixSocketPath;   // 非空时额外监听该路径的Unix域套接字，供同机的nginx绕过TCP协议栈
+    int jobTtlSeconds = 600;      // 异步任务结束后结果的保留时间
+    int maxJobs = 256;            // 同时保留的异步任务数上限（含未结束的任务）
+    bool coalesceRequests = true; // 合并相同的并发分析请求（接口、参数和数据集版本都相同），只计算一次
+    int coalesceWaitMs = 120000;  // 合并的请求等待计算结果的期限，超时回复503后关闭连接，0表示不限制
+    int drainTimeoutMs = 8000;    // 优雅停止时等待进行中请求完成的期限，应小于编排系统的强制终止宽限期
+};
+
+// HTTP服务器：持有监听套接字，并在少量线程上运行多个Reactor；
+// 默认所有Reactor共享一个监听套接字，reusePort模式下按核心分片接受连接
+class HttpServer {
+public:
+    HttpServer(ApiHandler& apiHandler, const ServerOptions& options);
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    // 创建监听套接字并启动事件循环线程
+    bool start();
+
+    // 优雅停止：拒绝新连接，等待进行中的请求完成并发出响应，最长等待drainTimeoutMs；
+    // 全部完成返回true。之后仍需调用stop()回收线程
+    bool drain();
+
+    // 停止所有事件循环并等待线程退出。正在执行的计算任务最多等到drain()的期限
+    // （未调用drain()时为drainTimeoutMs）；仍未结束时返回false，调用方应直接退出进程
+    bool stop();
+
+private:
+    ApiHandler& apiHandler_;
+    ServerOptions options_;
+    std::vector<int> listenFds_;
+    int unixListenFd_ = -1;
+    std::unique_ptr<ThreadPool> computePool_;
+    std::unique_ptr<AdmissionController> admission_;
+    std::unique_ptr<RateLimiter> rateLimiter_;
+    std::unique_ptr<JobManager> jobs_;
+    std::unique_ptr<RequestCoalescer> coalescer_;
+    std::vector<std::unique_ptr<Reactor>> reactors_;
+    std::vector<std::thread> threads_;
+    std::chrono::steady_clock::time_point drainDeadline_{};
+
+    int openListener(bool reusePort);
+    int openUnixListener();
+    std::unique_ptr<Reactor> createReactor(std::vector<int> listenFds, bool useUring);
+    static void pinThread(std::thread& thread, int core);
+};
+
+} // namespace QualityManagement
+
+#endif // HTTP_SERVER_H
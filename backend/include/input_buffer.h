@@ -0,0 +1,50 @@
+#ifndef INPUT_BUFFER_H
+#define INPUT_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+namespace QualityManagement {
+
+// 连接的接收缓冲：可读区间[readPos, writePos)，可写区间[writePos, capacity)；
+// recv直接写入缓冲尾部，解析器以string_view引用其中的数据，不做额外拷贝
+class InputBuffer {
+public:
+    InputBuffer() = default;
+
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+
+    // 尚未消费的数据
+    std::string_view readable() const {
+        return std::string_view(data_.get() + readPos_, writePos_ - readPos_);
+    }
+    size_t size() const { return writePos_ - readPos_; }
+    bool empty() const { return readPos_ == writePos_; }
+
+    // 确保至少有minWritable字节的可写空间，返回写入位置；可能移动已有数据
+    char* prepare(size_t minWritable);
+    size_t writable() const { return capacity_ - writePos_; }
+
+    // 确认prepare()之后写入了count字节
+    void commit(size_t count) { writePos_ += count; }
+
+    // 确保从当前读位置起能容纳total字节而无需再次扩容
+    void reserve(size_t total);
+
+    // 丢弃开头count字节（一个已处理完的请求）
+    void consume(size_t count);
+
+private:
+    std::unique_ptr<char[]> data_;
+    size_t capacity_ = 0;
+    size_t readPos_ = 0;
+    size_t writePos_ = 0;
+
+    void reallocate(size_t capacity);
+};
+
+} // namespace QualityManagement
+
+#endif // INPUT_BUFFER_H
@@ -0,0 +1,66 @@
+#ifndef IO_URING_H
+#define IO_URING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <linux/io_uring.h>
+
+struct iovec;
+
+namespace QualityManagement {
+
+// 直接基于io_uring系统调用的最小封装（不依赖liburing）：
+// 负责映射提交队列和完成队列、获取SQE、提交并等待完成事件
+class IoUring {
+public:
+    IoUring() = default;
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    // 检查内核是否支持服务器所需的全部操作
+    static bool isSupported();
+
+    // 创建entries个SQE槽位的环，失败时返回false并保留errno
+    bool init(unsigned entries);
+
+    // 注册固定缓冲，之后可用READ_FIXED读取而无需每次固定用户页
+    bool registerBuffers(const iovec* buffers, unsigned count);
+
+    // 获取一个已清零的SQE；提交队列已满时先提交已有的SQE再重试
+    io_uring_sqe* getSqe();
+
+    // 提交所有已填写的SQE，并等待至少waitCount个完成事件
+    int submitAndWait(unsigned waitCount);
+
+    // 取出一个完成事件，没有时返回false
+    bool popCqe(io_uring_cqe& cqe);
+
+private:
+    int ringFd_ = -1;
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned sqEntries_ = 0;
+    unsigned sqeTail_ = 0;        // 本地已填写但尚未发布给内核的SQE尾部
+
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    void flushSq();
+};
+
+} // namespace QualityManagement
+
+#endif // IO_URING_H
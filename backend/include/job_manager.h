@@ -0,0 +1,117 @@
+#ifndef JOB_MANAGER_H
+#define JOB_MANAGER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "body_format.h"
+
+namespace QualityManagement {
+
+// 一个异步分析任务：提交后立即返回任务号，计算线程执行完毕后保存结果，
+// 客户端轮询状态或订阅状态事件，稍后取回结果。所有方法线程安全
+class Job {
+public:
+    enum class Status {
+        Queued,
+        Running,
+        Done,
+        Failed,
+        Cancelled   // 服务器停止时仍在排队，未执行
+    };
+
+    // 投递一个已编码的SSE状态事件，last为true表示任务已结束、事件流随之关闭；
+    // 返回false表示订阅者已断开
+    using Subscriber = std::function<bool(const std::string& event, bool last)>;
+
+    // format为结果的格式，提交时按Accept协商，取结果时原样返回
+    Job(std::string id, std::string path, BodyFormat format = BodyFormat::Json);
+
+    const std::string& id() const { return id_; }
+    const std::string& path() const { return path_; }
+    BodyFormat format() const { return format_; }
+
+    // 计算线程调用：开始执行、报告已生成的结果字节数、保存结果
+    void start();
+    void addProgress(size_t bytes);
+    void finish(std::string result, bool ok);
+
+    // 任务仍在排队时标记为已取消并结束状态事件流，返回是否取消成功
+    bool cancel();
+
+    bool finished() const;
+    std::chrono::steady_clock::time_point finishedAt() const;
+
+    // 任务已结束时返回结果，否则返回nullptr
+    std::shared_ptr<const std::string> result() const;
+
+    // 当前状态的JSON（轮询接口的响应体和状态事件的载荷）
+    std::string statusJson() const;
+
+    // 订阅状态变化：立即投递一次当前状态，任务已结束时同时结束事件流
+    void subscribe(Subscriber subscriber);
+
+private:
+    const std::string id_;
+    const std::string path_;
+    const BodyFormat format_;
+    const std::chrono::steady_clock::time_point createdAt_;
+
+    mutable std::mutex mutex_;
+    Status status_ = Status::Queued;
+    size_t resultBytes_ = 0;
+    std::chrono::steady_clock::time_point startedAt_;
+    std::chrono::steady_clock::time_point finishedAt_;
+    std::chrono::steady_clock::time_point lastNotify_;
+    std::shared_ptr<const std::string> result_;
+    std::vector<Subscriber> subscribers_;
+
+    std::string statusJsonLocked() const;
+    void notifyLocked(bool last);
+};
+
+// 异步任务表：生成不可猜测的任务号，已结束的任务保留ttl后删除。
+// 删除在创建和查找时顺带进行，不需要单独的清理线程
+class JobManager {
+public:
+    // ttlMs为结果保留时间，maxJobs为同时保留的任务数上限（含未结束的任务）
+    JobManager(uint64_t ttlMs, size_t maxJobs);
+
+    // 创建任务；任务数已达上限且没有可以提前删除的已结束任务时返回nullptr
+    std::shared_ptr<Job> create(const std::string& path, BodyFormat format = BodyFormat::Json);
+
+    // 未知或已过期时返回nullptr
+    std::shared_ptr<Job> find(std::string_view id);
+
+    // 提交失败的任务立即删除
+    void remove(const std::string& id);
+
+    // 服务器停止、丢弃计算队列后调用：把仍在排队的任务标记为已取消，返回取消的任务数
+    size_t cancelQueued();
+
+    size_t size() const;
+    uint64_t ttlMs() const { return ttlMs_; }
+
+private:
+    const uint64_t ttlMs_;
+    const size_t maxJobs_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Job>> jobs_;
+    std::mt19937_64 random_;
+    std::chrono::steady_clock::time_point lastSweep_;
+
+    void expireLocked(std::chrono::steady_clock::time_point now, bool force);
+};
+
+} // namespace QualityManagement
+
+#endif // JOB_MANAGER_H
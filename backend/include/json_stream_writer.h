@@ -0,0 +1,94 @@
+#ifndef JSON_STREAM_WRITER_H
+#define JSON_STREAM_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "body_format.h"
+#include "grouped_data.h"
+#include "nlohmann/json.hpp"
+#include "response_sink.h"
+
+namespace QualityManagement {
+
+// 增量输出响应体：把编码结果追加到本地缓冲，超过阈值时整块交给ResponseSink，
+// 大数组逐元素序列化，内存占用与数据规模无关。
+// 标量直接编码进缓冲，不构造DOM；按构造时的格式输出JSON文本、CBOR或MessagePack，
+// JSON数值的排版规则与nlohmann::json::dump相同，二进制格式的编码与to_cbor/to_msgpack一致
+class JsonStreamWriter {
+public:
+    // 对象或数组成员个数事先未知
+    static constexpr size_t kUnknownCount = static_cast<size_t>(-1);
+
+    explicit JsonStreamWriter(ResponseSink& sink, BodyFormat format = BodyFormat::Json);
+
+    BodyFormat format() const { return format_; }
+
+    // 追加原样输出的JSON片段，只用于JSON格式
+    JsonStreamWriter& raw(std::string_view text);
+
+    // 追加一个值，只为这个值构造DOM
+    JsonStreamWriter& value(const nlohmann::json& value);
+
+    // 开始和结束一个对象；对象内以key()开始每个成员，成员之间的逗号自动补上。
+    // count为成员个数：CBOR未知个数时输出不定长映射；MessagePack的映射头必须带个数，
+    // 未知个数的对象结束前不能写出，流式输出的外层对象应给出个数
+    JsonStreamWriter& beginObject(size_t count = kUnknownCount);
+    JsonStreamWriter& endObject();
+    JsonStreamWriter& key(std::string_view name);
+
+    // 开始和结束一个含count个元素的数组
+    JsonStreamWriter& beginArray(size_t count);
+    JsonStreamWriter& endArray();
+
+    // 追加标量：数值为最短往返表示，非有限值输出null；字符串按JSON规则转义
+    JsonStreamWriter& number(double value);
+    JsonStreamWriter& number(int64_t value);
+    JsonStreamWriter& boolean(bool value);
+    JsonStreamWriter& string(std::string_view value);
+
+    // 追加一个数值数组
+    JsonStreamWriter& numberArray(SampleSpan values);
+
+    // 追加一个下标数组
+    JsonStreamWriter& indexArray(const std::vector<size_t>& values);
+
+    // 把缓冲中剩余的数据交给sink
+    bool flush();
+
+    // 客户端是否仍在接收
+    bool ok() const { return ok_; }
+
+private:
+    // 一层未结束的对象或数组
+    struct Frame {
+        bool array;
+        size_t expected;      // 声明的成员或元素个数
+        size_t count;         // 已写出的成员或元素个数
+        size_t headerPos;     // MessagePack未知个数对象的映射头在缓冲中的位置
+    };
+
+    ResponseSink& sink_;
+    const BodyFormat format_;
+    std::string buffer_;
+    std::vector<Frame> frames_;
+    size_t pinned_ = 0;       // 未结束的未知个数MessagePack对象数，期间缓冲不能写出
+    bool ok_ = true;
+
+    // 数组中的每个元素之前调用：JSON补逗号，并计数
+    void beginValue();
+    void closeFrame(bool array);
+
+    void appendNumber(double value);
+    void appendInteger(int64_t value);
+    void appendBinaryNumber(double value);
+    void appendHead(uint8_t major, uint64_t value);
+    void appendBigEndian(uint64_t value, int bytes);
+    void maybeFlush();
+};
+
+} // namespace QualityManagement
+
+#endif // JSON_STREAM_WRITER_H
@@ -0,0 +1,61 @@
+#ifndef OUTPUT_QUEUE_H
+#define OUTPUT_QUEUE_H
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+
+struct iovec;
+
+namespace QualityManagement {
+
+// 连接的发送队列：按顺序保存待发送的数据块（响应头、响应体），
+// 用sendmsg（即writev加MSG_NOSIGNAL）批量发送，部分发送时记录进度，等待EPOLLOUT后从断点继续
+class OutputQueue {
+public:
+    enum class WriteResult {
+        Drained,      // 队列已全部发送
+        WouldBlock,   // 发送缓冲区已满，需等待可写事件
+        Error         // 连接出错
+    };
+
+    // 追加一个数据块，字符串被移动进队列，不发生拷贝
+    void append(std::string chunk);
+
+    // 追加一个多个连接共享的只读数据块（如合并请求的同一份响应体），只增加引用计数
+    void append(std::shared_ptr<const std::string> chunk);
+
+    // 尽可能多地把队列中的数据写入套接字
+    WriteResult writeTo(int fd);
+
+    // 把队列前部最多maxCount个数据块填入iovec，返回填入的个数；
+    // 供异步发送使用，发送完成前不得修改队列前部
+    size_t prepareIovecs(iovec* iov, size_t maxCount) const;
+
+    // 确认已发送count字节
+    void advance(size_t count);
+
+    bool empty() const { return chunks_.empty(); }
+
+    // 队列中尚未发送的字节数
+    size_t pendingBytes() const { return pendingBytes_; }
+
+private:
+    // 独占的数据块或共享的只读数据块，二者只有一个非空
+    struct Chunk {
+        std::string owned;
+        std::shared_ptr<const std::string> shared;
+
+        std::string_view view() const { return shared ? std::string_view(*shared) : std::string_view(owned); }
+    };
+
+    std::deque<Chunk> chunks_;
+    size_t headOffset_ = 0;       // 队首数据块中已发送的字节数
+    size_t pendingBytes_ = 0;
+};
+
+} // namespace QualityManagement
+
+#endif // OUTPUT_QUEUE_H
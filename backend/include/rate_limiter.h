@@ -0,0 +1,55 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace QualityManagement {
+
+// 按客户端限流的令牌桶：每个客户端一个桶，按固定速率补充令牌，
+// 请求按接口权重消耗令牌，令牌不足时在解析请求体之前直接拒绝。
+// 桶存放在固定大小的开放寻址表中，状态（令牌数和上次补充时间）打包在一个64位原子量里，
+// 所有Reactor线程共享一个实例，无锁更新。表满时只回收已补满（即空闲）的桶，
+// 仍然找不到位置的客户端直接放行，限流退化但不会误伤。
+// 回收与扣除都通过状态的比较交换完成：回收时先把状态换成占位值，再改写客户端标识，
+// 扣除时先读状态再核对标识，状态交换成功即说明期间没有被回收给其他客户端
+class RateLimiter {
+public:
+    // ratePerSecond为每秒补充的令牌数，0表示不限流；burst为桶容量
+    RateLimiter(uint32_t ratePerSecond, uint32_t burst, size_t slotCount = 4096);
+
+    // 各接口消耗的令牌数，计算越重的接口越贵；/jobs/<接口>按接口本身计算
+    static uint32_t endpointCost(std::string_view path);
+
+    // 为客户端扣除cost个令牌：成功返回0，令牌不足时返回建议的重试等待秒数
+    int tryConsume(uint64_t clientKey, uint32_t cost);
+
+    bool enabled() const { return ratePerSecond_ > 0; }
+    uint64_t throttledCount() const { return throttled_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> key{0};     // 0表示空位
+        std::atomic<uint64_t> state{0};   // 高32位为剩余令牌（千分之一个），低32位为上次补充的毫秒时间
+    };
+
+    const uint64_t ratePerSecond_;        // 也是每毫秒补充的千分之一令牌数
+    const uint64_t capacity_;             // 桶容量（千分之一个令牌）
+    const size_t mask_;
+    const uint64_t startMs_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> throttled_{0};
+
+    bool consume(Slot& slot, uint64_t key, uint64_t need, uint32_t now, int& retryAfter);
+    bool claim(Slot& slot, uint64_t key, uint64_t need, uint32_t now);
+    static uint64_t loadState(const Slot& slot);
+    uint64_t refill(uint64_t state, uint32_t now) const;
+    uint32_t nowMs() const;
+};
+
+} // namespace QualityManagement
+
+#endif // RATE_LIMITER_H
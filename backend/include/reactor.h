@@ -0,0 +1,271 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "admission_control.h"
+#include "api_handler.h"
+#include "compression.h"
+#include "http_parser.h"
+#include "http_response.h"
+#include "http_server.h"
+#include "input_buffer.h"
+#include "job_manager.h"
+#include "output_queue.h"
+#include "rate_limiter.h"
+#include "request_coalescer.h"
+#include "response_stream.h"
+#include "spool_file.h"
+#include "thread_pool.h"
+#include "timer_wheel.h"
+
+namespace QualityManagement {
+
+// 连接当前所处的超时阶段
+enum class TimerPhase {
+    None,         // 请求正在计算且没有待发送的数据，不计时
+    Coalesced,    // 等待合并计算的结果，计算不结束时回复503后关闭
+    Write,        // 请求正在计算且有待发送的数据（流式分块或上一个响应），客户端须持续读取
+    Header,       // 等待完整的请求头
+    Body,         // 等待Content-Length字节的请求体
+    Idle,         // 长连接上两个请求之间的空闲，或等待响应发送完毕后关闭
+    Heartbeat     // 事件流连接上定期发送心跳
+};
+
+// 请求体暂存到磁盘的请求：请求头已从接收缓冲中移除，字段拷贝到这里，
+// 请求体边接收边追加到临时文件，接收完整后连同文件一起交给计算线程
+struct SpooledRequest {
+    std::string method;
+    std::string path;
+    std::string version;
+    std::string realIp;
+    std::string contentType;
+    std::string accept;
+    size_t contentLength = 0;
+    bool keepAlive = true;
+    std::unique_ptr<SpoolFile> file;
+};
+
+// 单个客户端连接的状态
+struct Connection {
+    explicit Connection(size_t maxBodySize)
+        : parser(maxBodySize), input(std::make_shared<InputBuffer>()) {}
+
+    // 连接关闭时唤醒仍在生成流式响应的计算线程，并退订事件流
+    ~Connection() {
+        if (stream) {
+            stream->abort();
+        }
+        if (eventStreamOpen) {
+            eventStreamOpen->store(false, std::memory_order_release);
+        }
+        if (onClose) {
+            onClose();
+        }
+    }
+
+    int fd = -1;
+    uint64_t id = 0;              // 连接序号，用于识别描述符被复用后的旧完成通知
+    bool busy = false;            // 是否有请求正在计算线程池中处理
+    bool coalesced = false;       // 正在等待合并计算的结果
+    bool closeAfterWrite = false; // 当前响应发送完后关闭连接（Connection: close或请求错误）
+    bool peerClosed = false;      // 对端已关闭写方向
+    bool served = false;          // 是否已处理过至少一个请求（区分新连接与空闲长连接）
+    bool trustedPeer = false;     // 对端是本机的反向代理（回环地址或Unix域套接字），可信任X-Real-IP
+    uint64_t clientKey = 0;       // 由对端地址得到的客户端标识，用于限流
+    HttpParser parser;            // 可恢复的请求解析状态机
+    std::shared_ptr<InputBuffer> input; // 接收缓冲，计算中的请求持有其引用
+    OutputQueue output;           // 待发送的响应数据块
+    std::shared_ptr<ResponseStream> stream; // 正在发送的流式响应
+    std::shared_ptr<SpooledRequest> spool;  // 正在接收的超大请求体
+    bool eventStream = false;     // 连接已转为Server-Sent Events事件流，直到关闭不再处理请求
+    std::shared_ptr<std::atomic<bool>> eventStreamOpen; // 订阅者据此判断连接是否仍然存在
+    std::function<void()> onClose; // 连接析构时调用，用于及时移除事件流的订阅者
+    size_t streamQueued = 0;      // 已入队但尚未确认写出的流式响应字节数
+    TimerNode timer;              // 请求头、请求体或空闲期限
+    TimerPhase timerPhase = TimerPhase::None;
+
+    // 以下字段仅由io_uring后端使用：已提交尚未完成的操作引用着连接的内存，完成前连接不能释放
+    bool recvPending = false;
+    bool sendPending = false;
+    bool closing = false;         // 已关闭套接字读写，等待未完成的操作返回后释放
+    int fixedBuffer = -1;         // 接收使用的注册缓冲序号，-1表示直接读入接收缓冲
+    bool discardPending = false;  // 已请求丢弃接收缓冲，等待被取消的接收操作返回后再清空
+    msghdr sendMessage{};
+    iovec sendIovecs[16];
+};
+
+// 事件循环基类，一个Reactor在一个线程中运行，负责接受新连接并复用处理其上所有连接；
+// HTTP请求的解析、分派和响应入队与I/O方式无关，放在基类中；
+// 具体的套接字读写由EpollReactor（就绪通知）或UringReactor（完成通知）实现。
+// API计算交给线程池执行，结果通过完成队列回到所属的Reactor线程发送
+class Reactor {
+public:
+    Reactor(ApiHandler& apiHandler, ThreadPool& computePool, AdmissionController& admission,
+            RateLimiter& rateLimiter, JobManager& jobs, RequestCoalescer& coalescer,
+            std::vector<int> listenFds, const ServerOptions& options);
+    virtual ~Reactor();
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    // 创建事件通知所需的内核对象
+    virtual bool init() = 0;
+
+    // 运行事件循环，直到stop()被调用
+    virtual void run() = 0;
+
+    // 请求事件循环退出（线程安全）
+    void stop();
+
+    // 开始优雅停止（线程安全）：不再接受新连接，立即关闭空闲连接，
+    // 进行中的请求完成并发出响应后关闭连接；所有连接关闭后事件循环自行退出
+    void beginDrain();
+
+    // 是否已开始优雅停止（线程安全）；此后构造的响应头都应带Connection: close
+    bool draining() const { return draining_.load(std::memory_order_acquire); }
+
+    // 事件循环是否已退出（线程安全）
+    bool finished() const { return finished_.load(std::memory_order_acquire); }
+
+    // 由计算线程调用，把已生成的响应交还给连接所属的Reactor（线程安全）；
+    // 流式响应的中间分块last为false，请求在最后一个分块到达后才算完成
+    void postCompletion(int fd, uint64_t connectionId, HttpResponse response, bool last = true);
+
+protected:
+    // 计算线程产生的响应
+    struct Completion {
+        int fd;
+        uint64_t connectionId;
+        HttpResponse response;
+        bool last;
+    };
+
+    ApiHandler& apiHandler_;
+    ThreadPool& computePool_;
+    AdmissionController& admission_;
+    RateLimiter& rateLimiter_;
+    JobManager& jobs_;
+    RequestCoalescer& coalescer_;
+    std::vector<int> listenFds_;  // TCP监听套接字，以及可选的Unix域套接字
+    const ServerOptions& options_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> draining_{false};
+    std::atomic<bool> finished_{false};
+    bool drainStarted_ = false;   // 事件循环线程已处理过停止请求
+    uint64_t nextConnectionId_ = 1;
+    TimerWheel timers_;           // 先于连接构造、后于连接析构，连接中的定时器节点析构时仍可摘除
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+
+    std::mutex completionMutex_;
+    std::vector<Completion> completions_;
+
+    // 合并计算的结束保证，由负责计算的任务持有
+    class FlightGuard;
+
+    // 唤醒阻塞中的事件循环（线程安全）
+    virtual void wakeup() = 0;
+
+    // 请求完成后继续处理连接：恢复接收、处理缓冲中的后续请求并发送响应
+    virtual void resumeConnection(Connection& conn) = 0;
+
+    // 请求仍在处理中时发送已入队的数据（流式响应的中间分块）
+    virtual void flushConnection(Connection& conn) = 0;
+
+    virtual void closeConnection(int fd) = 0;
+
+    // 丢弃接收缓冲中的全部数据（请求出错或超时，连接应答后关闭）；
+    // io_uring后端的接收操作可能正直接写入接收缓冲，须先取消接收，操作返回后再清空
+    virtual void discardInput(Connection& conn) = 0;
+
+    bool isListener(int fd) const;
+
+    // 不再从监听套接字接受连接
+    virtual void stopAccepting() = 0;
+
+    // 每轮事件处理后调用：首次发现需要停止时停止接受连接并关闭空闲连接；
+    // 返回true表示所有连接都已关闭，事件循环可以退出
+    bool drainComplete();
+
+    // address为accept得到的对端地址，Unix域套接字上可以为空
+    Connection& addConnection(int fd, const sockaddr* address, socklen_t addressLength);
+    void handleCompletions();
+
+    // 解析并分派接收缓冲中已完整的请求；调用时不能有接收操作正在写入接收缓冲
+    // （io_uring后端只在接收返回后或计算结束后调用，计算期间不提交接收）
+    void processRequests(Connection& conn);
+
+    // spool非空时请求体在其临时文件中，request.body为空
+    void dispatchRequest(Connection& conn, const HttpRequest& request,
+                         std::shared_ptr<SpooledRequest> spool = nullptr);
+
+    // 请求头已完整时判断是否把请求体暂存到磁盘，是则移除请求头并开始暂存
+    bool beginSpool(Connection& conn);
+
+    // 把接收缓冲中的请求体追加到临时文件，请求体完整时分派请求；
+    // 返回false表示请求体尚未接收完整
+    bool continueSpool(Connection& conn);
+
+    // 合并相同的并发分析请求：第一个请求计算，其余请求等待同一结果；
+    // 返回false表示该请求不适合合并，按普通请求处理
+    bool coalesceRequest(Connection& conn, const HttpRequest& request, const std::string& path, bool keepAlive);
+
+    // 合并计算结束：把同一响应体发给key下的全部等待者，响应体只保存一份，
+    // 需要压缩时每种编码只压缩一次；format为响应体的格式（键中已协商的响应格式）
+    void completeCoalesced(const std::string& key, std::string body, const char* status = "200 OK",
+                           const std::string& extraHeaders = std::string(),
+                           BodyFormat format = BodyFormat::Json) const;
+
+    // 计算线程调用：以已按format生成的响应体构造响应，达到阈值时按协商的编码压缩；
+    // 计算期间已开始停止时改为Connection: close
+    HttpResponse makeApiResponse(std::string body, bool keepAlive, ContentEncoding encoding,
+                                 BodyFormat format = BodyFormat::Json) const;
+
+    // 限流（429）、超出准入预算或任务队列已满（503）时的拒绝响应，带Retry-After
+    void rejectWithRetry(Connection& conn, bool keepAlive, const char* status, const char* message, int retryAfter);
+
+    // 在事件循环中直接应答GET /health、/ready和/metrics，路径不匹配时返回false
+    bool handleProbe(Connection& conn, const HttpRequest& request, bool keepAlive);
+
+    // 投递一个已编码的SSE事件，last为true时发送后关闭事件流；返回false表示连接已关闭
+    using EventSubscriber = std::function<bool(const std::string& event, bool last)>;
+
+    // 把连接转为事件流并调用subscribe登记订阅者；onComputePool为true时subscribe在计算线程中执行，
+    // 否则直接在事件循环中执行（订阅本身很轻，且不能排在它要观察的计算任务之后）
+    // open为连接是否仍然存在的标志，供订阅方剔除失效的订阅者；onClose在连接关闭时调用
+    using EventSubscription = std::function<void(EventSubscriber subscriber,
+                                                 std::shared_ptr<const std::atomic<bool>> open)>;
+    void openEventStream(Connection& conn, bool keepAlive, EventSubscription subscribe, bool onComputePool,
+                         std::function<void()> onClose = nullptr);
+
+    // POST /jobs/<接口>：创建异步任务并立即返回任务号，path为去掉/jobs前缀后的接口路径
+    void submitJob(Connection& conn, const HttpRequest& request, const std::string& path,
+                   std::shared_ptr<AdmissionTicket> ticket, bool keepAlive);
+
+    // GET /jobs/<任务号>[/result|/events]：查询状态、取回结果或订阅状态事件
+    void handleJobQuery(Connection& conn, const HttpRequest& request, bool keepAlive);
+    void queueResponse(Connection& conn, HttpResponse response);
+    void finishRequest(Connection& conn);
+
+    // 响应有字节写入套接字后调用：顺延空闲或发送期限，并确认流式响应的发送进度
+    void reportWriteProgress(Connection& conn);
+
+    // 按连接当前阶段设置超时期限
+    void updateDeadline(Connection& conn);
+
+    // 处理已到期的连接：请求接收到一半时回复408，空闲或停止读取响应的连接直接关闭
+    void expireTimers();
+    void handleTimeout(Connection& conn);
+};
+
+} // namespace QualityManagement
+
+#endif // REACTOR_H
@@ -0,0 +1,47 @@
+#ifndef REQUEST_COALESCER_H
+#define REQUEST_COALESCER_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "compression.h"
+
+namespace QualityManagement {
+
+class Reactor;
+
+// 合并相同的并发请求（singleflight）：键由接口、规范化后的参数和数据集版本组成，
+// 第一个请求负责计算，计算期间到达的相同请求只登记等待，
+// 计算完成后所有等待者共享同一份序列化好的响应体。所有Reactor共享一个实例
+class RequestCoalescer {
+public:
+    // 等待结果的连接；keepAlive和encoding决定各自的响应头和压缩方式
+    struct Waiter {
+        Reactor* reactor;
+        int fd;
+        uint64_t connectionId;
+        bool keepAlive;
+        ContentEncoding encoding;
+    };
+
+    // 登记等待者；返回true表示没有进行中的相同请求，调用方负责计算并在结束后调用complete
+    bool join(const std::string& key, const Waiter& waiter);
+
+    // 计算结束（或失败），取出全部等待者（包括负责计算的请求本身）
+    std::vector<Waiter> complete(const std::string& key);
+
+    // 因合并而省去计算的请求数
+    uint64_t coalescedCount() const { return coalesced_.load(std::memory_order_relaxed); }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<Waiter>> flights_;
+    std::atomic<uint64_t> coalesced_{0};
+};
+
+} // namespace QualityManagement
+
+#endif // REQUEST_COALESCER_H
@@ -0,0 +1,33 @@
+#ifndef RESPONSE_SINK_H
+#define RESPONSE_SINK_H
+
+#include <string>
+
+namespace QualityManagement {
+
+// 响应体的分段输出端：处理函数边生成边写出，不必先在内存中拼出完整响应
+class ResponseSink {
+public:
+    virtual ~ResponseSink() = default;
+
+    // 写出一段响应体；返回false表示客户端已断开，处理函数应尽快停止生成
+    virtual bool write(std::string chunk) = 0;
+};
+
+// 把所有分段收集到一个字符串中，供非流式调用方使用
+class StringSink : public ResponseSink {
+public:
+    bool write(std::string chunk) override {
+        data_ += chunk;
+        return true;
+    }
+
+    std::string take() { return std::move(data_); }
+
+private:
+    std::string data_;
+};
+
+} // namespace QualityManagement
+
+#endif // RESPONSE_SINK_H
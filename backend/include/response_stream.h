@@ -0,0 +1,71 @@
+#ifndef RESPONSE_STREAM_H
+#define RESPONSE_STREAM_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "body_format.h"
+#include "compression.h"
+#include "response_sink.h"
+
+namespace QualityManagement {
+
+class Reactor;
+
+// 以分块传输编码发送的流式响应：计算线程写入的每一段响应体
+// 封装成一个HTTP分块，经完成队列交给连接所属的Reactor发送。
+// 已提交但尚未写入套接字的字节超过上限时写入方阻塞，
+// 慢速客户端不会让服务器在内存中积压整个响应。
+// 协商了压缩时先缓存开头的内容，累计达到阈值后才开始压缩并发出响应头，
+// 总量不足阈值的响应在结束时原样发出
+class ResponseStream : public ResponseSink {
+public:
+    // writeTimeoutMs为积压等待期间没有任何发送进度时放弃的期限，0表示不限制；
+    // format为响应体的格式，决定Content-Type
+    ResponseStream(Reactor& reactor, int fd, uint64_t connectionId, bool keepAlive, size_t maxBacklog,
+                   int writeTimeoutMs, BodyFormat format, ContentEncoding encoding = ContentEncoding::Identity, int compressionLevel = 0,
+                   size_t compressionThreshold = 0);
+
+    // 计算线程调用：写出一段响应体，必要时等待发送进度；连接已关闭时返回false
+    bool write(std::string chunk) override;
+
+    // 计算线程调用：写出结束分块，ok为false时发送已有内容后关闭连接
+    void finish(bool ok);
+
+    // Reactor线程调用：确认已有count字节写入套接字，唤醒等待中的写入方
+    void release(size_t count);
+
+    // Reactor线程调用：连接已关闭，之后的写入立即失败
+    void abort();
+
+private:
+    Reactor& reactor_;
+    const int fd_;
+    const uint64_t connectionId_;
+    const bool keepAlive_;
+    const size_t maxBacklog_;     // 允许积压的最大字节数
+    const std::chrono::milliseconds writeTimeout_;
+    const BodyFormat format_;
+    const ContentEncoding encoding_;
+    const int compressionLevel_;
+    const size_t compressionThreshold_;
+    bool started_ = false;        // 响应头是否已发出（只由计算线程访问）
+    std::string pending_;         // 尚未决定是否压缩的开头内容
+    std::unique_ptr<Compressor> compressor_; // 已决定压缩时的压缩状态
+
+    // 把一段（可能已压缩的）响应体作为分块提交给Reactor
+    bool send(std::string chunk);
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    size_t backlog_ = 0;          // 已提交给Reactor但尚未写入套接字的字节数
+    bool aborted_ = false;
+};
+
+} // namespace QualityManagement
+
+#endif // RESPONSE_STREAM_H
@@ -0,0 +1,28 @@
+#ifndef SERVER_CONFIG_H
+#define SERVER_CONFIG_H
+
+#include <string>
+#include "http_server.h"
+
+namespace QualityManagement {
+
+// 进程运行配置：服务器参数加上进程级设置
+struct RuntimeConfig {
+    ServerOptions server;
+    std::string stateFile;        // 非空时退出前保存数据集、启动时恢复
+};
+
+enum class ConfigStatus {
+    Run,        // 配置有效，继续启动
+    Help,       // 已打印用法，正常退出
+    Invalid     // 配置有误，错误信息已输出
+};
+
+// 运行时加载配置，优先级从低到高：默认值、配置文件、环境变量、命令行参数。
+// 配置文件为JSON对象，键与命令行参数同名（不含前缀--），由--config或QMS_CONFIG指定；
+// 每个参数都有对应的QMS_前缀环境变量，如--worker-threads对应QMS_WORKER_THREADS
+ConfigStatus loadRuntimeConfig(int argc, char* argv[], RuntimeConfig& config);
+
+} // namespace QualityManagement
+
+#endif // SERVER_CONFIG_H
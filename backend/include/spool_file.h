@@ -0,0 +1,47 @@
+#ifndef SPOOL_FILE_H
+#define SPOOL_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace QualityManagement {
+
+// 超大请求体的临时文件：在指定目录中创建没有名字的文件（O_TMPFILE，
+// 文件系统不支持时mkstemp后立即unlink），关闭即释放磁盘空间。
+// 接收时由Reactor线程顺序追加，处理时由计算线程整体映射为只读内存，
+// 请求体的数据留在页缓存中而不占用进程的堆内存；
+// 也可以只读打开已有的文件（如启动时恢复的数据文件），同样整体映射后解析
+class SpoolFile {
+public:
+    // 创建失败（目录不存在、无权限等）时返回nullptr
+    static std::unique_ptr<SpoolFile> create(const std::string& directory);
+
+    // 只读打开已有的文件，只能映射不能追加；文件不存在或打开失败时返回nullptr
+    static std::unique_ptr<SpoolFile> openReadOnly(const std::string& path);
+
+    ~SpoolFile();
+
+    SpoolFile(const SpoolFile&) = delete;
+    SpoolFile& operator=(const SpoolFile&) = delete;
+
+    // 追加数据，磁盘已满等错误时返回false
+    bool append(const char* data, size_t size);
+
+    size_t size() const { return size_; }
+
+    // 把已写入的内容映射为只读内存，之后不能再追加；失败时返回空
+    std::string_view map();
+
+private:
+    explicit SpoolFile(int fd) : fd_(fd) {}
+
+    int fd_;
+    size_t size_ = 0;
+    void* mapping_ = nullptr;
+};
+
+} // namespace QualityManagement
+
+#endif // SPOOL_FILE_H
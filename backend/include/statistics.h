@@ -4,6 +4,7 @@
 #include <vector>
 #include <map>
 #include <string>
+#include "grouped_data.h"
 
 namespace QualityManagement {
 
@@ -86,6 +87,9 @@ struct ControlChartData {
     double uclRange;                  // 极差控制图上控制限
     double lclRange;                  // 极差控制图下控制限
     bool isControlled;                // 过程是否处于统计受控状态
+    std::vector<size_t> outOfControlPoints; // 均值或极差超出控制限的子组序号
+    std::vector<size_t> meanOutOfControlPoints;  // 均值超出均值图控制限的子组序号
+    std::vector<size_t> rangeOutOfControlPoints; // 极差超出极差图控制限的子组序号
 };
 
 // 过程评估结构体
@@ -100,12 +104,20 @@ public:
     Statistics();
     ~Statistics();
     
-    // 设置数据
-    void setData(const std::vector<std::vector<double>>& data);
+    // 设置数据；数据集直接移入，不做拷贝
+    void setData(GroupedData data);
+    
+    // 在已有数据之后追加子组，只计算新子组的均值和极差
+    void appendData(const GroupedData& groups);
+    
+    // 当前数据集
+    const GroupedData& data() const { return data_; }
+    
+    // 子组数
+    size_t groupCount() const { return groupMeans_.size(); }
     
     // 生成样本数据
-    std::vector<std::vector<double>> generateSampleData(int groups, int samplesPerGroup, 
-                                                       double mean, double stddev);
+    GroupedData generateSampleData(int groups, int samplesPerGroup, double mean, double stddev);
     
     // 计算整体描述性统计量
     DescriptiveStats calculateOverallStats();
@@ -125,32 +137,32 @@ public:
     // 计算过程能力指数
     CapabilityIndices calculateCapabilityIndices(double lsl, double usl);
     
-    // 生成控制图数据
-    ControlChartData generateControlChartData();
+    // 生成控制图数据；means和ranges只包含从firstGroup开始的子组，
+    // 控制限和失控点仍按全部子组计算
+    ControlChartData generateControlChartData(size_t firstGroup = 0);
     
     // 评估过程
     ProcessAssessment assessProcess(double lsl, double usl);
     
 private:
-    std::vector<std::vector<double>> data_;  // 原始分组数据
-    std::vector<double> flatData_;           // 扁平化数据（用于整体分析）
+    GroupedData data_;                       // 分组数据，整体分析直接使用其连续的样本数组
     std::vector<double> groupMeans_;         // 组均值
     std::vector<double> groupRanges_;        // 组极差
     
     // 计算均值
-    double calculateMean(const std::vector<double>& data);
+    double calculateMean(SampleSpan data);
     
     // 计算中位数
-    double calculateMedian(std::vector<double> data);
+    double calculateMedian(SampleSpan data);
     
     // 计算方差
-    double calculateVariance(const std::vector<double>& data, double mean);
+    double calculateVariance(SampleSpan data, double mean);
     
     // 计算偏度
-    double calculateSkewness(const std::vector<double>& data, double mean, double stdDev);
+    double calculateSkewness(SampleSpan data, double mean, double stdDev);
     
     // 计算峰度
-    double calculateKurtosis(const std::vector<double>& data, double mean, double stdDev);
+    double calculateKurtosis(SampleSpan data, double mean, double stdDev);
     
     // 计算正态分布概率
     double normalCDF(double x, double mean, double stdDev);
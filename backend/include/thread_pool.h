@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace QualityManagement {
+
+// 固定线程数、有界任务队列的计算线程池，用于把统计计算与网络I/O隔离
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    ThreadPool(size_t threadCount, size_t queueCapacity);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 提交任务，队列已满或线程池已关闭时立即返回false，不会阻塞调用线程
+    bool trySubmit(Task task);
+
+    // 停止接收新任务，执行完队列中剩余任务后等待所有线程退出；
+    // discardQueued为true时丢弃尚未开始的任务，只等待正在执行的任务，返回丢弃的任务数
+    size_t shutdown(bool discardQueued = false);
+
+    // 停止接收新任务并丢弃尚未开始的任务（数量写入discarded），最多等待timeout让正在执行的任务结束；
+    // 超时返回false，此时工作线程已被分离，线程池对象必须保持存活直到进程退出
+    bool shutdownFor(std::chrono::milliseconds timeout, size_t& discarded);
+
+    // 当前排队等待执行的任务数
+    size_t queueDepth() const;
+
+    size_t threadCount() const { return workers_.size(); }
+    size_t queueCapacity() const { return queueCapacity_; }
+
+private:
+    const size_t queueCapacity_;
+    std::vector<std::thread> workers_;
+    std::deque<Task> tasks_;
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::condition_variable exited_;
+    size_t liveWorkers_ = 0;
+    bool stopping_ = false;
+
+    size_t beginShutdown(bool discardQueued);
+    void workerLoop();
+};
+
+} // namespace QualityManagement
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,80 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace QualityManagement {
+
+class TimerWheel;
+
+// 嵌入在被计时对象中的定时器节点，挂在时间轮槽位的侵入式双向链表上；
+// 析构时自动取消，对象释放后不会留下悬空节点
+struct TimerNode {
+    TimerNode() = default;
+    ~TimerNode() { cancel(); }
+
+    TimerNode(const TimerNode&) = delete;
+    TimerNode& operator=(const TimerNode&) = delete;
+
+    // 从时间轮中摘除，O(1)
+    void cancel();
+
+    bool scheduled() const { return wheel != nullptr; }
+
+    uint64_t key = 0;             // 由使用方设置，用于在到期回调中找回所属对象
+    uint64_t expiry = 0;          // 到期的刻度
+    TimerNode* prev = nullptr;
+    TimerNode* next = nullptr;
+    TimerWheel* wheel = nullptr;
+};
+
+// 分层时间轮：4层、每层64个槽位，低层槽位按刻度到期，高层槽位在低层转完一圈时
+// 下放到更低的层。设置和取消都是O(1)，每个刻度只处理到期的槽位，
+// 与定时器总数无关。只在所属的事件循环线程中使用，不加锁
+class TimerWheel {
+public:
+    using Callback = std::function<void(TimerNode&)>;
+
+    explicit TimerWheel(uint64_t tickMs);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // 在delayMs毫秒后到期；节点已在计时时先取消原定时
+    void schedule(TimerNode& node, uint64_t delayMs);
+
+    // 推进到当前时间，对每个到期节点调用callback（调用前节点已摘除）
+    void advance(const Callback& callback);
+
+    bool empty() const { return count_ == 0; }
+    uint64_t tickMs() const { return tickMs_; }
+
+private:
+    friend struct TimerNode;
+
+    static const int kLevels = 4;
+    static const int kSlotBits = 6;
+    static const int kSlots = 1 << kSlotBits;
+
+    // 每个槽位是带哨兵的环形链表
+    struct Slot {
+        TimerNode head;
+        Slot() { head.prev = head.next = &head; }
+    };
+
+    const uint64_t tickMs_;
+    const uint64_t startMs_;
+    uint64_t currentTick_ = 0;
+    size_t count_ = 0;
+    Slot slots_[kLevels][kSlots];
+
+    void place(TimerNode& node);
+    void cascade(int level);
+    static uint64_t nowMs();
+};
+
+} // namespace QualityManagement
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,80 @@
+#ifndef URING_REACTOR_H
+#define URING_REACTOR_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "io_uring.h"
+#include "reactor.h"
+
+namespace QualityManagement {
+
+// 基于io_uring完成通知的事件循环：accept、recv和send以异步操作提交，
+// 一次io_uring_enter同时完成提交与收割，小请求不再需要epoll_wait加recv加sendmsg三次系统调用。
+// 短请求读入预先注册的固定缓冲（READ_FIXED），省去每次读取时固定用户页的开销
+class UringReactor : public Reactor {
+public:
+    using Reactor::Reactor;
+    ~UringReactor() override;
+
+    // 创建io_uring实例、注册固定缓冲和唤醒描述符
+    bool init() override;
+
+    void run() override;
+
+protected:
+    void wakeup() override;
+    void resumeConnection(Connection& conn) override;
+    void flushConnection(Connection& conn) override;
+    void closeConnection(int fd) override;
+    void discardInput(Connection& conn) override;
+    void stopAccepting() override;
+
+private:
+    // 写入user_data低8位的操作类型，高位为套接字描述符
+    enum Op : uint64_t {
+        OpAccept = 1,
+        OpWakeup,
+        OpRecv,
+        OpSend,
+        OpTimer,
+        OpCancel
+    };
+
+    IoUring ring_;
+    int wakeFd_ = -1;
+    uint64_t wakeValue_ = 0;          // 异步读取eventfd的目标
+    size_t pendingOps_ = 0;           // 已提交但尚未完成的操作数
+    size_t acceptsPending_ = 0;       // 每个监听套接字各有一个accept操作
+
+    // accept操作写入的对端地址，与listenFds_一一对应
+    struct AcceptAddress {
+        sockaddr_storage address;
+        socklen_t length;
+    };
+    std::vector<AcceptAddress> acceptAddresses_;
+    bool timerPending_ = false;
+    bool timerFailed_ = false;        // 内核拒绝超时操作，不再提交
+    __kernel_timespec timerSpec_{};   // 时间轮刻度，作为超时操作的参数
+    std::unique_ptr<char[]> fixedBuffers_;
+    std::vector<int> freeFixedBuffers_;
+
+    void armAccept(int listenFd);
+    void armWakeup();
+    void armTimer();
+    void armRecv(Connection& conn);
+    void flushOutput(Connection& conn);
+    void continueConnection(Connection& conn);
+    void handleCqe(const io_uring_cqe& cqe);
+    void handleAccept(int listenFd, int result);
+    AcceptAddress& acceptAddress(int listenFd);
+    void handleRecv(Connection& conn, int result);
+    void handleSend(Connection& conn, int result);
+    void releaseIfIdle(Connection& conn);
+    void drain();
+    io_uring_sqe* prepareSqe(int fd, Op op);
+};
+
+} // namespace QualityManagement
+
+#endif // URING_REACTOR_H
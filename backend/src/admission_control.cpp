@@ -0,0 +1,79 @@
+#include "../include/admission_control.h"
+#include <algorithm>
+
+namespace QualityManagement {
+
+namespace {
+
+const uint64_t kBaseCost = 1000;     // 每个请求的固定开销（解析、序列化等）
+const int kMaxRetryAfter = 30;       // Retry-After的上限（秒）
+const uint64_t kMaxSamples = 1ull << 48;  // 估算时样本点数的上限，乘以权重不会溢出
+
+// 各接口每个样本点的相对计算量：排序类检验（中位数、Shapiro-Wilk）比单次遍历更重，
+// 综合分析包含全部分析
+struct EndpointWeight {
+    std::string_view path;
+    uint64_t weight;
+};
+
+const EndpointWeight kWeights[] = {
+    {"/all-analysis", 8},
+    {"/normality-test", 3},
+    {"/descriptive-stats", 3},
+    {"/process-assessment", 3},
+    {"/capability-indices", 2},
+    {"/control-chart", 1},
+    {"/mean-test", 1},
+    {"/generate-data", 1},
+};
+
+} // namespace
+
+AdmissionController::AdmissionController(uint64_t budget) : budget_(budget) {
+}
+
+uint64_t AdmissionController::estimateCost(std::string_view path, size_t bodySize, size_t sampleCount,
+                                          uint64_t requestedSamples) {
+    // 导入的代价取决于请求体而不是现有数据：每个数值在JSON中约占8字节
+    if (path == "/import-data" || path == "/append-data") {
+        return kBaseCost + bodySize / 8;
+    }
+    // 生成数据的代价取决于请求要求的规模，空数据集上生成海量数据同样占满预算
+    uint64_t samples = path == "/generate-data" ? requestedSamples : sampleCount;
+    for (const auto& entry : kWeights) {
+        if (entry.path == path) {
+            samples = std::min(samples, kMaxSamples);
+            return kBaseCost + entry.weight * samples;
+        }
+    }
+    return kBaseCost;
+}
+
+bool AdmissionController::tryAdmit(uint64_t cost) {
+    uint64_t current = inFlight_.load(std::memory_order_relaxed);
+    do {
+        if (budget_ > 0 && current > 0 && current + cost > budget_) {
+            shed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!inFlight_.compare_exchange_weak(current, current + cost, std::memory_order_relaxed));
+
+    admitted_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void AdmissionController::release(uint64_t cost) {
+    inFlight_.fetch_sub(cost, std::memory_order_relaxed);
+}
+
+int AdmissionController::retryAfterSeconds() const {
+    if (budget_ == 0) {
+        return 1;
+    }
+    // 已接纳的工作量每相当于一个预算，建议多等两秒
+    uint64_t load = inFlight_.load(std::memory_order_relaxed);
+    uint64_t seconds = 1 + load * 2 / budget_;
+    return static_cast<int>(std::min<uint64_t>(seconds, kMaxRetryAfter));
+}
+
+} // namespace QualityManagement
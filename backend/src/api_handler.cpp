@@ -1,184 +1,603 @@
 #include "../include/api_handler.h"
+#include "../include/json_stream_writer.h"
+#include "../include/spool_file.h"
 #include "../include/nlohmann/json.hpp"  // 添加JSON库的包含
 #include <iostream>
 #include <algorithm>
 #include <numeric>
-#include <map>
-#include <functional>
+#include <array>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
 
 namespace QualityManagement {
 
 // 使用nlohmann的json库
 using json = nlohmann::json;
 
+namespace {
+
+// SAX解析使用的输入格式
+json::input_format_t saxFormat(BodyFormat format) {
+    switch (format) {
+    case BodyFormat::Cbor: return json::input_format_t::cbor;
+    case BodyFormat::MessagePack: return json::input_format_t::msgpack;
+    case BodyFormat::Json: break;
+    }
+    return json::input_format_t::json;
+}
+
+const int kDefaultGroups = 25;           // /generate-data未指定时生成的子组数
+const int kDefaultSamplesPerGroup = 5;   // /generate-data未指定时每组的样本数
+
+const size_t kRouteSlots = 37;       // 路由哈希表的槽位数，取使各路径互不冲突的值
+const uint8_t kNoRoute = 0xff;       // 空槽位
+
+// 路径的FNV-1a哈希，编译期建表和运行时查找使用同一函数
+constexpr uint32_t routeHash(std::string_view path) {
+    uint32_t hash = 2166136261u;
+    for (char c : path) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+// 各路由的哈希槽位互不相同，查找时不需要处理冲突
+template <typename Route, size_t N>
+constexpr bool routeHashIsPerfect(const Route (&routes)[N]) {
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = i + 1; j < N; ++j) {
+            if (routeHash(routes[i].path) % kRouteSlots == routeHash(routes[j].path) % kRouteSlots) {
+                return false;
+            }
+        }
+    }
+    return N < kNoRoute;
+}
+
+// 槽位到路由下标的映射
+template <typename Route, size_t N>
+constexpr std::array<uint8_t, kRouteSlots> buildRouteSlots(const Route (&routes)[N]) {
+    std::array<uint8_t, kRouteSlots> slots{};
+    for (size_t i = 0; i < kRouteSlots; ++i) {
+        slots[i] = kNoRoute;
+    }
+    for (size_t i = 0; i < N; ++i) {
+        slots[routeHash(routes[i].path) % kRouteSlots] = static_cast<uint8_t>(i);
+    }
+    return slots;
+}
+
+// 把分段直接写入文件，保存大数据集时不在内存中拼出完整字符串
+class FileSink : public ResponseSink {
+public:
+    explicit FileSink(std::ofstream& file) : file_(file) {}
+
+    bool write(std::string chunk) override {
+        file_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        return static_cast<bool>(file_);
+    }
+
+private:
+    std::ofstream& file_;
+};
+
+// /import-data和/append-data请求体的SAX处理器：只关心根对象中"data"数组下各个数组里的数值，
+// 非数值元素和空分组被忽略；数值逐个追加到列式存储，不构建JSON树也不经过临时的分组数组
+class ImportDataSax : public json::json_sax_t {
+public:
+    bool null() override { return scalar(); }
+    bool boolean(bool) override { return scalar(); }
+    bool number_integer(number_integer_t value) override { return number(static_cast<double>(value)); }
+    bool number_unsigned(number_unsigned_t value) override { return number(static_cast<double>(value)); }
+    bool number_float(number_float_t value, const string_t&) override { return number(value); }
+    bool string(string_t&) override { return scalar(); }
+    bool binary(binary_t&) override { return scalar(); }
+
+    bool start_object(std::size_t) override {
+        if (depth_ == 0) {
+            rootIsObject_ = true;
+        }
+        scalar();
+        ++depth_;
+        return true;
+    }
+
+    bool key(string_t& name) override {
+        if (depth_ == 1) {
+            dataKey_ = name == "data";
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        --depth_;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (depth_ == 1 && dataKey_) {
+            // 重复的"data"以最后一个为准，与构建JSON树时一致
+            groups_.clear();
+            found_ = true;
+            inData_ = true;
+            dataKey_ = false;
+        } else if (depth_ == 2 && inData_) {
+            inGroup_ = true;
+        } else if (depth_ == 0) {
+            rootIsObject_ = false;
+        }
+        ++depth_;
+        return true;
+    }
+
+    bool end_array() override {
+        --depth_;
+        if (depth_ == 2 && inGroup_) {
+            groups_.closeGroup();
+            inGroup_ = false;
+        } else if (depth_ == 1 && inData_) {
+            inData_ = false;
+        }
+        return true;
+    }
+
+    // 异常信息会带上出错前读到的整段内容（包括空白），超大请求体上只报告位置
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception&) override {
+        error_ = "JSON解析错误: 第" + std::to_string(position) + "字节处语法错误";
+        return false;
+    }
+
+    bool valid() const { return rootIsObject_ && found_; }
+    const std::string& error() const { return error_; }
+    GroupedData& groups() { return groups_; }
+
+private:
+    int depth_ = 0;
+    bool rootIsObject_ = false;
+    bool dataKey_ = false;    // 根对象中刚读到的键是"data"
+    bool found_ = false;      // 根对象中有数组类型的"data"
+    bool inData_ = false;
+    bool inGroup_ = false;
+    GroupedData groups_;      // 数值直接追加到最终的列式存储中
+    std::string error_;
+
+    bool number(double value) {
+        if (depth_ == 3 && inGroup_) {
+            groups_.appendValue(value);
+            return true;
+        }
+        return scalar();
+    }
+
+    // "data"的值不是数组时视为没有数据
+    bool scalar() {
+        if (depth_ == 1 && dataKey_) {
+            groups_.clear();
+            found_ = false;
+            dataKey_ = false;
+        }
+        return true;
+    }
+};
+
+
+// 写出一个小对象（错误信息等）作为完整响应体
+bool writeValue(JsonStreamWriter& out, const json& value) {
+    out.value(value);
+    return out.flush();
+}
+
+// 统计结果结构体直接写成JSON对象成员，不经过DOM；成员按键名字典序输出，与nlohmann::json对象的顺序一致
+void writeMembers(JsonStreamWriter& out, const DescriptiveStats& stats) {
+    out.key("kurtosis").number(stats.kurtosis);
+    out.key("maximum").number(stats.maximum);
+    out.key("mean").number(stats.mean);
+    out.key("median").number(stats.median);
+    out.key("minimum").number(stats.minimum);
+    out.key("range").number(stats.range);
+    out.key("sampleSize").number(static_cast<int64_t>(stats.sampleSize));
+    out.key("skewness").number(stats.skewness);
+    out.key("standardDeviation").number(stats.standardDeviation);
+    out.key("variance").number(stats.variance);
+}
+
+void writeMembers(JsonStreamWriter& out, const NormalityTest& test) {
+    out.key("conclusion").string(test.conclusion);
+    out.key("isNormal").boolean(test.isNormal);
+    out.key("pValue").number(test.pValue);
+    out.key("statistic").number(test.statistic);
+    out.key("testMethod").string(test.testMethod);
+}
+
+void writeMembers(JsonStreamWriter& out, const MeanTest& test) {
+    out.key("alpha").number(test.alpha);
+    out.key("conclusion").string(test.conclusion);
+    out.key("expectedMean").number(test.expectedMean);
+    out.key("pValue").number(test.pValue);
+    out.key("sampleMean").number(test.sampleMean);
+    out.key("tStatistic").number(test.tStatistic);
+    out.key("testResult").boolean(test.testResult);
+}
+
+void writeMembers(JsonStreamWriter& out, const CapabilityIndices& indices) {
+    out.key("cp").number(indices.cp);
+    out.key("cpk").number(indices.cpk);
+    out.key("cpl").number(indices.cpl);
+    out.key("cpm").number(indices.cpm);
+    out.key("cpu").number(indices.cpu);
+    out.key("k").number(indices.k);
+    out.key("lsl").number(indices.lsl);
+    out.key("overall").beginObject();
+    out.key("lowerZ").number(indices.overall.lowerZ);
+    out.key("sigma").number(indices.overall.sigma);
+    out.key("upperZ").number(indices.overall.upperZ);
+    out.endObject();
+    out.key("pp").number(indices.pp);
+    out.key("ppk").number(indices.ppk);
+    out.key("ppm").beginObject();
+    out.key("expected").number(indices.ppm.expected);
+    out.key("observed").number(indices.ppm.observed);
+    out.endObject();
+    out.key("usl").number(indices.usl);
+    out.key("within").beginObject();
+    out.key("lowerZ").number(indices.within.lowerZ);
+    out.key("sigma").number(indices.within.sigma);
+    out.key("upperZ").number(indices.within.upperZ);
+    out.endObject();
+}
+
+void writeMembers(JsonStreamWriter& out, const ProcessAssessment& assessment) {
+    out.key("capabilityLevel").string(assessment.capabilityLevel);
+    out.key("recommendations").string(assessment.recommendations);
+    out.key("stabilityStatus").string(assessment.stabilityStatus);
+}
+
+void writeMembers(JsonStreamWriter& out, const ControlChartData& chartData) {
+    out.key("clMean").number(chartData.clMean);
+    out.key("clRange").number(chartData.clRange);
+    out.key("isControlled").boolean(chartData.isControlled);
+    out.key("lclMean").number(chartData.lclMean);
+    out.key("lclRange").number(chartData.lclRange);
+    out.key("means").numberArray(chartData.means);
+    out.key("outOfControlPoints").indexArray(chartData.outOfControlPoints);
+    out.key("ranges").numberArray(chartData.ranges);
+    out.key("uclMean").number(chartData.uclMean);
+    out.key("uclRange").number(chartData.uclRange);
+}
+
+} // namespace
+
 ApiHandler::ApiHandler() : statistics_(std::make_unique<Statistics>()) {
-    // 初始化路由表
-    std::map<std::string, std::function<json(const json&)>> routes;
-    routes["/generate-data"] = [this](const json& params) { return this->handleGenerateData(params); };
-    routes["/import-data"] = [this](const json& params) { return this->handleImportData(params); };
-    routes["/descriptive-stats"] = [this](const json& params) { return this->handleDescriptiveStats(params); };
-    routes["/normality-test"] = [this](const json& params) { return this->handleNormalityTest(params); };
-    routes["/mean-test"] = [this](const json& params) { return this->handleMeanTest(params); };
-    routes["/capability-indices"] = [this](const json& params) { return this->handleCapabilityIndices(params); };
-    routes["/control-chart"] = [this](const json& params) { return this->handleControlChart(params); };
-    routes["/process-assessment"] = [this](const json& params) { return this->handleProcessAssessment(params); };
-    routes["/all-analysis"] = [this](const json& params) { return this->handleAllAnalysis(params); };
 }
 
 ApiHandler::~ApiHandler() {
     // 析构函数
 }
 
-std::string ApiHandler::handleRequest(const std::string& path, const std::string& requestBody) {
-    try {
-        // 解析请求体为JSON
-        nlohmann::json requestParams;
-        if (!requestBody.empty()) {
-            try {
-                requestParams = nlohmann::json::parse(requestBody);
-            } catch (const nlohmann::json::exception& e) {
-                return nlohmann::json({
-                    {"success", false}, 
-                    {"error", std::string("JSON解析错误: ") + e.what()},
-                    {"errorType", "json_parse_error"}
-                }).dump();
-            }
+std::string ApiHandler::handleRequest(const std::string& path, std::string_view requestBody,
+                                      BodyFormat requestFormat, BodyFormat responseFormat) {
+    const Route* route = findRoute(path);
+    if (route != nullptr && route->rawHandler != nullptr) {
+        try {
+            StringSink sink;
+            JsonStreamWriter out(sink, responseFormat);
+            (this->*route->rawHandler)(requestBody, requestFormat, out);
+            return sink.take();
+        } catch (const std::exception& e) {
+            return encodeValue(json({
+                {"success", false},
+                {"error", std::string("处理请求时发生错误: ") + e.what()}
+            }), responseFormat);
         }
-        
-        // 创建路由表
-        std::map<std::string, std::function<nlohmann::json(const nlohmann::json&)>> routes;
-        routes["/generate-data"] = [this](const nlohmann::json& params) { 
-            return nlohmann::json::parse(this->handleGenerateData(params.dump())); 
-        };
-        routes["/import-data"] = [this](const nlohmann::json& params) { 
-            return nlohmann::json::parse(this->handleImportData(params.dump())); 
-        };
-        routes["/descriptive-stats"] = [this](const nlohmann::json& params) { 
-            return nlohmann::json::parse(this->handleDescriptiveStats(params.dump())); 
-        };
-        routes["/normality-test"] = [this](const nlohmann::json& params) { 
-            return nlohmann::json::parse(this->handleNormalityTest(params.dump())); 
-        };
-        routes["/mean-test"] = [this](const nlohmann::json& params) { 
-            return nlohmann::json::parse(this->handleMeanTest(params.dump())); 
-        };
-        routes["/capability-indices"] = [this](const nlohmann::json& params) { 
-            return nlohmann::json::parse(this->handleCapabilityIndices(params.dump())); 
-        };
-        routes["/control-chart"] = [this](const nlohmann::json& params) { 
-            return nlohmann::json::parse(this->handleControlChart(params.dump())); 
-        };
-        routes["/process-assessment"] = [this](const nlohmann::json& params) { 
-            return nlohmann::json::parse(this->handleProcessAssessment(params.dump())); 
-        };
-        routes["/all-analysis"] = [this](const nlohmann::json& params) { 
-            return nlohmann::json::parse(this->handleAllAnalysis(params.dump())); 
-        };
-        
-        // 查找路由处理函数
-        auto it = routes.find(path);
-        if (it != routes.end()) {
-            try {
-                // 调用对应的处理函数
-                nlohmann::json response = it->second(requestParams);
-                return response.dump();
-            } catch (const nlohmann::json::exception& e) {
-                // 捕获JSON异常
-                return nlohmann::json({
-                    {"success", false}, 
-                    {"error", std::string("JSON处理错误: ") + e.what()},
-                    {"errorType", "json_process_error"}
-                }).dump();
-            } catch (const std::exception& e) {
-                // 捕获其他异常
-                return nlohmann::json({
-                    {"success", false}, 
-                    {"error", std::string("处理请求时发生错误: ") + e.what()}
-                }).dump();
-            }
+    }
+    
+    json params;
+    try {
+        params = decodeBody(requestBody, requestFormat);
+    } catch (const json::exception& e) {
+        return encodeValue(json({
+            {"success", false},
+            {"error", std::string("JSON解析错误: ") + e.what()},
+            {"errorType", "json_parse_error"}
+        }), responseFormat);
+    }
+    return handleParsedRequest(path, params, responseFormat);
+}
+
+std::string ApiHandler::handleParsedRequest(std::string_view path, const json& params, BodyFormat responseFormat) {
+    const Route* route = findRoute(path);
+    if (route == nullptr) {
+        return encodeValue(json({
+            {"success", false},
+            {"error", "路由不存在: " + std::string(path)}
+        }), responseFormat);
+    }
+    try {
+        // 处理方法直接按响应格式写出响应体，不再解析和重新序列化
+        StringSink sink;
+        JsonStreamWriter out(sink, responseFormat);
+        if (route->handler == nullptr) {
+            (this->*route->rawHandler)(params.dump(), BodyFormat::Json, out);
         } else {
-            // 未找到路由
-            return nlohmann::json({
-                {"success", false},
-                {"error", "路由不存在: " + path}
-            }).dump();
+            (this->*route->handler)(params, out);
         }
+        return sink.take();
+    } catch (const json::exception& e) {
+        return encodeValue(json({
+            {"success", false},
+            {"error", std::string("JSON处理错误: ") + e.what()},
+            {"errorType", "json_process_error"}
+        }), responseFormat);
     } catch (const std::exception& e) {
-        // 处理异常
-        return nlohmann::json({
-            {"success", false}, 
+        return encodeValue(json({
+            {"success", false},
             {"error", std::string("处理请求时发生错误: ") + e.what()}
-        }).dump();
+        }), responseFormat);
+    }
+}
+
+bool ApiHandler::saveData(const std::string& filePath) const {
+    std::string tempPath = filePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "无法写入数据文件: " << tempPath << std::endl;
+            return false;
+        }
+        FileSink sink(file);
+        JsonStreamWriter out(sink);
+        
+        std::shared_lock<std::shared_mutex> lock(dataMutex_);
+        const GroupedData& data = statistics_->data();
+        out.raw("{\"data\":[");
+        for (size_t i = 0; i < data.groupCount() && out.ok(); ++i) {
+            if (i > 0) {
+                out.raw(",");
+            }
+            out.numberArray(data.group(i));
+        }
+        out.raw("]}");
+        if (!out.flush() || !file.flush()) {
+            std::cerr << "写入数据文件失败: " << tempPath << std::endl;
+            return false;
+        }
+    }
+    if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+        std::cerr << "重命名数据文件失败: " << filePath << std::endl;
+        return false;
     }
+    return true;
 }
 
-std::string ApiHandler::handleGenerateData(const std::string& requestBody) {
+bool ApiHandler::loadData(const std::string& filePath) {
+    // 整体映射为只读内存，SAX解析器直接读取页缓存，文件内容不在堆上复制
+    std::unique_ptr<SpoolFile> file = SpoolFile::openReadOnly(filePath);
+    if (!file) {
+        return false;
+    }
+    std::string_view contents = file->map();
+    size_t groupCount = 0;
+    std::string error;
+    if (contents.empty() || !replaceData(contents, BodyFormat::Json, groupCount, error)) {
+        std::cerr << "恢复数据集失败: " << filePath << (error.empty() ? "" : ": " + error) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ApiHandler::updateSampleCount() {
+    sampleCount_.store(statistics_->data().size(), std::memory_order_release);
+    dataVersion_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+std::string ApiHandler::controlChartEvent(size_t firstGroup) const {
+    StringSink sink;
+    JsonStreamWriter out(sink);
+    out.beginObject();
+    if (statistics_->groupCount() == 0) {
+        out.key("groups").number(int64_t(0));
+        out.key("means").raw("[]");
+        out.key("ranges").raw("[]");
+    } else {
+        // 追加事件只带新子组，控制限和失控点按全部子组重新计算
+        ControlChartData chartData = statistics_->generateControlChartData(firstGroup);
+        writeMembers(out, chartData);
+        out.key("groups").number(static_cast<int64_t>(statistics_->groupCount()));
+    }
+    out.key("start").number(static_cast<int64_t>(firstGroup));
+    out.endObject();
+    out.flush();
+    return sink.take();
+}
+
+void ApiHandler::publishControlChart(size_t firstGroup) {
+    if (!chartFeed_.hasSubscribers()) {
+        return;
+    }
+    chartFeed_.publish(ControlChartFeed::encodeEvent(firstGroup == 0 ? "snapshot" : "append",
+                                                     controlChartEvent(firstGroup)));
+}
+
+void ApiHandler::subscribeControlChart(ControlChartFeed::Subscriber subscriber, ControlChartFeed::Liveness alive) {
+    // 持有读锁时数据不会变化，快照与之后的追加事件之间不会遗漏或重复
+    std::shared_lock<std::shared_mutex> lock(dataMutex_);
+    if (subscriber(ControlChartFeed::encodeEvent("snapshot", controlChartEvent(0)))) {
+        chartFeed_.subscribe(std::move(subscriber), std::move(alive));
+    }
+}
+
+void ApiHandler::pruneControlChartSubscribers() {
+    chartFeed_.prune();
+}
+
+const ApiHandler::Route* ApiHandler::findRoute(std::string_view path) {
+    // 路由表在编译期确定，查找时只计算一次哈希并比较一次字符串，不分配内存
+    static constexpr Route kRoutes[] = {
+        {"/generate-data", &ApiHandler::streamGenerateData, nullptr, false, true},
+        {"/import-data", nullptr, &ApiHandler::handleImportData, false, false},
+        {"/append-data", nullptr, &ApiHandler::handleAppendData, false, false},
+        {"/descriptive-stats", &ApiHandler::handleDescriptiveStats, nullptr, true, false},
+        {"/normality-test", &ApiHandler::handleNormalityTest, nullptr, true, false},
+        {"/mean-test", &ApiHandler::handleMeanTest, nullptr, true, false},
+        {"/capability-indices", &ApiHandler::handleCapabilityIndices, nullptr, true, false},
+        {"/control-chart", &ApiHandler::handleControlChart, nullptr, true, false},
+        {"/process-assessment", &ApiHandler::handleProcessAssessment, nullptr, true, false},
+        {"/all-analysis", &ApiHandler::streamAllAnalysis, nullptr, true, true},
+    };
+    static_assert(routeHashIsPerfect(kRoutes), "路由路径的哈希槽位冲突，需调整kRouteSlots");
+    static constexpr auto kSlots = buildRouteSlots(kRoutes);
+
+    uint8_t index = kSlots[routeHash(path) % kRouteSlots];
+    if (index == kNoRoute || kRoutes[index].path != path) {
+        return nullptr;
+    }
+    return &kRoutes[index];
+}
+
+bool ApiHandler::hasRoute(std::string_view path) const {
+    return findRoute(path) != nullptr;
+}
+
+bool ApiHandler::isReadOnlyRoute(std::string_view path) const {
+    const Route* route = findRoute(path);
+    return route != nullptr && route->readOnly;
+}
+
+bool ApiHandler::isStreamingRoute(std::string_view path) const {
+    const Route* route = findRoute(path);
+    return route != nullptr && route->streaming;
+}
+
+bool ApiHandler::handleStreamingRequest(const std::string& path, std::string_view requestBody, ResponseSink& sink,
+                                        BodyFormat requestFormat, BodyFormat responseFormat) {
+    JsonStreamWriter out(sink, responseFormat);
+    json params;
+    try {
+        params = decodeBody(requestBody, requestFormat);
+    } catch (const json::exception& e) {
+        out.value(json({
+            {"success", false},
+            {"error", std::string("JSON解析错误: ") + e.what()},
+            {"errorType", "json_parse_error"}
+        }));
+        return out.flush();
+    }
+    const Route* route = findRoute(path);
+    if (route == nullptr || !route->streaming) {
+        return writeValue(out, json({{"success", false}, {"error", "路由不存在: " + path}}));
+    }
+    return (this->*route->handler)(params, out);
+}
+
+uint64_t ApiHandler::generatedSampleCount(const json& params) {
+    // 参数类型不对时处理函数会报错，不产生计算量
     try {
-        json params = json::parse(requestBody);
-        int groups = params.value("groups", 25);
-        int samplesPerGroup = params.value("samplesPerGroup", 5);
+        int groups = params.value("groups", kDefaultGroups);
+        int samplesPerGroup = params.value("samplesPerGroup", kDefaultSamplesPerGroup);
+        if (groups <= 0 || samplesPerGroup <= 0) {
+            return 0;
+        }
+        return static_cast<uint64_t>(groups) * static_cast<uint64_t>(samplesPerGroup);
+    } catch (const json::exception&) {
+        return 0;
+    }
+}
+
+bool ApiHandler::streamGenerateData(const json& params, JsonStreamWriter& out) {
+    GroupedData generated;
+    try {
+        int groups = params.value("groups", kDefaultGroups);
+        int samplesPerGroup = params.value("samplesPerGroup", kDefaultSamplesPerGroup);
         double mean = params.value("mean", 100.0);
         double stddev = params.value("stddev", 10.0);
         
         // 生成数据
-        data_ = statistics_->generateSampleData(groups, samplesPerGroup, mean, stddev);
-        
-        // 更新统计类中的数据
-        statistics_->setData(data_);
+        std::unique_lock<std::shared_mutex> lock(dataMutex_);
+        generated = statistics_->generateSampleData(groups, samplesPerGroup, mean, stddev);
         
-        // 转换为JSON格式返回
-        json result;
-        for (size_t i = 0; i < data_.size(); ++i) {
-            json group;
-            for (size_t j = 0; j < data_[i].size(); ++j) {
-                group.push_back(data_[i][j]);
-            }
-            result.push_back(group);
-        }
-        
-        return json({{"success", true}, {"data", result}}).dump();
+        // 更新统计类中的数据，保留一份用于在锁外写出响应
+        statistics_->setData(generated);
+        updateSampleCount();
+        publishControlChart(0);
     } catch (const std::exception& e) {
-        return json({{"success", false}, {"error", e.what()}}).dump();
+        return writeValue(out, json({{"success", false}, {"error", e.what()}}));
     }
+    
+    // 在锁外逐组序列化返回，慢速客户端不会阻塞其他请求；
+    // 外层对象和数组给出个数，MessagePack输出也能边生成边发送
+    out.beginObject(2).key("data").beginArray(generated.groupCount());
+    for (size_t i = 0; i < generated.groupCount() && out.ok(); ++i) {
+        out.numberArray(generated.group(i));
+    }
+    out.endArray().key("success").boolean(true).endObject();
+    return out.flush();
 }
 
-std::string ApiHandler::handleImportData(const std::string& requestBody) {
-    try {
-        json params = json::parse(requestBody);
-        
-        // 检查参数是否为数组格式
-        if (params.contains("data") && params["data"].is_array()) {
-            data_.clear();
-            for (const auto& group : params["data"]) {
-                if (group.is_array()) {
-                    std::vector<double> groupData;
-                    for (const auto& item : group) {
-                        if (item.is_number()) {
-                            groupData.push_back(item.get<double>());
-                        }
-                    }
-                    if (!groupData.empty()) {
-                        data_.push_back(groupData);
-                    }
-                }
-            }
-            
-            // 更新统计类中的数据
-            statistics_->setData(data_);
-            
-            return json({{"success", true}, {"message", "数据导入成功"}, {"count", data_.size()}}).dump();
-        } else {
-            return json({{"success", false}, {"error", "无效的参数格式"}}).dump();
-        }
-    } catch (const std::exception& e) {
-        return json({{"success", false}, {"error", e.what()}}).dump();
+std::string ApiHandler::importData(std::string_view requestBody, BodyFormat format) {
+    StringSink sink;
+    JsonStreamWriter out(sink);
+    handleImportData(requestBody, format, out);
+    return sink.take();
+}
+
+bool ApiHandler::replaceData(std::string_view body, BodyFormat format, size_t& groupCount, std::string& error) {
+    ImportDataSax sax;
+    if (!json::sax_parse(body.begin(), body.end(), &sax, saxFormat(format))) {
+        error = sax.error();
+        return false;
+    }
+    if (!sax.valid()) {
+        error = "无效的参数格式";
+        return false;
+    }
+    
+    // 解析结果就是数据集的最终存储，整体移入统计类
+    std::unique_lock<std::shared_mutex> lock(dataMutex_);
+    statistics_->setData(std::move(sax.groups()));
+    updateSampleCount();
+    publishControlChart(0);
+    groupCount = statistics_->groupCount();
+    return true;
+}
+
+bool ApiHandler::handleImportData(std::string_view requestBody, BodyFormat format, JsonStreamWriter& out) {
+    size_t groupCount = 0;
+    std::string error;
+    if (!replaceData(requestBody, format, groupCount, error)) {
+        return writeValue(out, json({{"success", false}, {"error", error}}));
     }
+    return writeValue(out, json({{"success", true}, {"message", "数据导入成功"}, {"count", groupCount}}));
 }
 
-std::string ApiHandler::handleDescriptiveStats(const std::string& requestBody) {
+bool ApiHandler::handleAppendData(std::string_view requestBody, BodyFormat format, JsonStreamWriter& out) {
+    // 格式与导入相同，新子组接在已有数据之后
+    ImportDataSax sax;
+    if (!json::sax_parse(requestBody.begin(), requestBody.end(), &sax, saxFormat(format))) {
+        return writeValue(out, json({{"success", false}, {"error", sax.error()}}));
+    }
+    if (!sax.valid()) {
+        return writeValue(out, json({{"success", false}, {"error", "无效的参数格式"}}));
+    }
+    
+    const GroupedData& groups = sax.groups();
+    std::unique_lock<std::shared_mutex> lock(dataMutex_);
+    size_t firstGroup = statistics_->groupCount();
+    statistics_->appendData(groups);
+    updateSampleCount();
+    if (!groups.empty()) {
+        publishControlChart(firstGroup);
+    }
+    
+    return writeValue(out, json({{"success", true}, {"count", groups.groupCount()}, {"total", statistics_->groupCount()}}));
+}
+
+bool ApiHandler::handleDescriptiveStats(const json& params, JsonStreamWriter& out) {
     try {
-        if (data_.empty()) {
-            return json({{"success", false}, {"error", "没有可用数据"}}).dump();
+        std::shared_lock<std::shared_mutex> lock(dataMutex_);
+        if (statistics_->data().empty()) {
+            return writeValue(out, json({{"success", false}, {"error", "没有可用数据"}}));
         }
         
         // 计算整体描述性统计量
@@ -187,20 +606,6 @@ std::string ApiHandler::handleDescriptiveStats(const std::string& requestBody) {
         // 计算每组的统计量
         std::vector<DescriptiveStats> groupStats = statistics_->calculateGroupStats();
         
-        // 计算总体组统计量
-        json overallResult = {
-            {"mean", stats.mean},
-            {"variance", stats.variance},
-            {"standardDeviation", stats.standardDeviation},
-            {"range", stats.range},
-            {"minimum", stats.minimum},
-            {"maximum", stats.maximum},
-            {"median", stats.median},
-            {"skewness", stats.skewness},
-            {"kurtosis", stats.kurtosis},
-            {"sampleSize", stats.sampleSize}
-        };
-        
         // 生成直方图数据
         std::vector<double> histogram = statistics_->generateHistogram();
         
@@ -227,56 +632,51 @@ std::string ApiHandler::handleDescriptiveStats(const std::string& requestBody) {
             groupMaxAvg /= groupStats.size();
         }
         
-        json groupsResult = {
-            {"mean", groupMeanAvg},
-            {"standardDeviation", groupStdDevAvg},
-            {"range", groupRangeAvg},
-            {"minimum", groupMinAvg},
-            {"maximum", groupMaxAvg}
-        };
-        
-        return json({
-            {"success", true}, 
-            {"stats", {
-                {"overall", overallResult},
-                {"groups", groupsResult},
-                {"histogram", histogram}
-            }}
-        }).dump();
+        out.beginObject().key("stats").beginObject();
+        out.key("groups").beginObject();
+        out.key("maximum").number(groupMaxAvg);
+        out.key("mean").number(groupMeanAvg);
+        out.key("minimum").number(groupMinAvg);
+        out.key("range").number(groupRangeAvg);
+        out.key("standardDeviation").number(groupStdDevAvg);
+        out.endObject();
+        out.key("histogram").numberArray(histogram);
+        out.key("overall").beginObject();
+        writeMembers(out, stats);
+        out.endObject();
+        out.endObject().key("success").boolean(true).endObject();
+        return out.flush();
     } catch (const std::exception& e) {
-        return json({{"success", false}, {"error", e.what()}}).dump();
+        return writeValue(out, json({{"success", false}, {"error", e.what()}}));
     }
 }
 
-std::string ApiHandler::handleNormalityTest(const std::string& requestBody) {
+bool ApiHandler::handleNormalityTest(const json& params, JsonStreamWriter& out) {
     try {
-        if (data_.empty()) {
-            return json({{"success", false}, {"error", "没有可用数据"}}).dump();
+        std::shared_lock<std::shared_mutex> lock(dataMutex_);
+        if (statistics_->data().empty()) {
+            return writeValue(out, json({{"success", false}, {"error", "没有可用数据"}}));
         }
         
         // 进行正态性检验
         NormalityTest test = statistics_->testNormality();
         
-        return json({
-            {"success", true}, 
-            {"isNormal", test.isNormal}, 
-            {"pValue", test.pValue},
-            {"statistic", test.statistic},
-            {"testMethod", test.testMethod},
-            {"conclusion", test.conclusion}
-        }).dump();
+        out.beginObject();
+        writeMembers(out, test);
+        out.key("success").boolean(true).endObject();
+        return out.flush();
     } catch (const std::exception& e) {
-        return json({{"success", false}, {"error", e.what()}}).dump();
+        return writeValue(out, json({{"success", false}, {"error", e.what()}}));
     }
 }
 
-std::string ApiHandler::handleMeanTest(const std::string& requestBody) {
+bool ApiHandler::handleMeanTest(const json& params, JsonStreamWriter& out) {
     try {
-        if (data_.empty()) {
-            return json({{"success", false}, {"error", "没有可用数据"}}).dump();
+        std::shared_lock<std::shared_mutex> lock(dataMutex_);
+        if (statistics_->data().empty()) {
+            return writeValue(out, json({{"success", false}, {"error", "没有可用数据"}}));
         }
         
-        json params = json::parse(requestBody);
         // 期望的总体均值，默认为100
         double expectedMean = params.value("expectedMean", 100.0);
         double alpha = params.value("alpha", 0.05);
@@ -284,28 +684,22 @@ std::string ApiHandler::handleMeanTest(const std::string& requestBody) {
         // 进行均值检验
         MeanTest result = statistics_->testMean(expectedMean, alpha);
         
-        return json({
-            {"success", true}, 
-            {"sampleMean", result.sampleMean},
-            {"expectedMean", result.expectedMean},
-            {"tStatistic", result.tStatistic},
-            {"pValue", result.pValue},
-            {"alpha", result.alpha},
-            {"testResult", result.testResult},
-            {"conclusion", result.conclusion}
-        }).dump();
+        out.beginObject();
+        writeMembers(out, result);
+        out.key("success").boolean(true).endObject();
+        return out.flush();
     } catch (const std::exception& e) {
-        return json({{"success", false}, {"error", e.what()}}).dump();
+        return writeValue(out, json({{"success", false}, {"error", e.what()}}));
     }
 }
 
-std::string ApiHandler::handleCapabilityIndices(const std::string& requestBody) {
+bool ApiHandler::handleCapabilityIndices(const json& params, JsonStreamWriter& out) {
     try {
-        if (data_.empty()) {
-            return json({{"success", false}, {"error", "没有可用数据"}}).dump();
+        std::shared_lock<std::shared_mutex> lock(dataMutex_);
+        if (statistics_->data().empty()) {
+            return writeValue(out, json({{"success", false}, {"error", "没有可用数据"}}));
         }
         
-        json params = json::parse(requestBody);
         // 规格限
         double lsl = params.value("lsl", 70.0); // 下规格限
         double usl = params.value("usl", 130.0); // 上规格限
@@ -313,99 +707,47 @@ std::string ApiHandler::handleCapabilityIndices(const std::string& requestBody)
         // 计算能力指数
         CapabilityIndices indices = statistics_->calculateCapabilityIndices(lsl, usl);
         
-        // 构建包含所有字段的响应
-        json response = {
-            {"success", true}, 
-            {"cp", indices.cp},
-            {"cpk", indices.cpk},
-            {"cpl", indices.cpl},
-            {"cpu", indices.cpu},
-            {"pp", indices.pp},
-            {"ppk", indices.ppk},
-            {"k", indices.k},
-            {"lsl", indices.lsl},
-            {"usl", indices.usl},
-            {"cpm", indices.cpm},
-            {"within", {
-                {"sigma", indices.within.sigma},
-                {"lowerZ", indices.within.lowerZ},
-                {"upperZ", indices.within.upperZ}
-            }},
-            {"overall", {
-                {"sigma", indices.overall.sigma},
-                {"lowerZ", indices.overall.lowerZ},
-                {"upperZ", indices.overall.upperZ}
-            }},
-            {"ppm", {
-                {"expected", indices.ppm.expected},
-                {"observed", indices.ppm.observed}
-            }}
-        };
-        
-        return response.dump();
+        out.beginObject();
+        writeMembers(out, indices);
+        out.key("success").boolean(true).endObject();
+        return out.flush();
     } catch (const json::exception& e) {
         // 处理JSON异常
-        return json({
+        return writeValue(out, json({
             {"success", false}, 
             {"error", std::string("JSON处理错误: ") + e.what()}
-        }).dump();
+        }));
     } catch (const std::exception& e) {
-        return json({{"success", false}, {"error", e.what()}}).dump();
+        return writeValue(out, json({{"success", false}, {"error", e.what()}}));
     }
 }
 
-std::string ApiHandler::handleControlChart(const std::string& requestBody) {
+bool ApiHandler::handleControlChart(const json& params, JsonStreamWriter& out) {
     try {
-        if (data_.empty()) {
-            return json({{"success", false}, {"error", "没有可用数据"}}).dump();
+        std::shared_lock<std::shared_mutex> lock(dataMutex_);
+        if (statistics_->data().empty()) {
+            return writeValue(out, json({{"success", false}, {"error", "没有可用数据"}}));
         }
         
         // 生成控制图数据
         ControlChartData chartData = statistics_->generateControlChartData();
         
-        // 转换为JSON格式返回 - 确保所有字段类型一致
-        json means = json::array();
-        for (const auto& mean : chartData.means) {
-            means.push_back(mean);
-        }
-        
-        json ranges = json::array();
-        for (const auto& range : chartData.ranges) {
-            ranges.push_back(range);
-        }
-        
-        // 始终使用数组类型
-        json outOfControlPoints = json::array();
-        
-        json response = {
-            {"success", true}, 
-            {"data", {
-                {"means", means},
-                {"ranges", ranges},
-                {"uclMean", chartData.uclMean},
-                {"lclMean", chartData.lclMean},
-                {"clMean", chartData.clMean},
-                {"uclRange", chartData.uclRange},
-                {"lclRange", chartData.lclRange},
-                {"clRange", chartData.clRange},
-                {"isControlled", chartData.isControlled},
-                {"outOfControlPoints", outOfControlPoints}
-            }}
-        };
-        
-        return response.dump();
+        out.beginObject().key("data").beginObject();
+        writeMembers(out, chartData);
+        out.endObject().key("success").boolean(true).endObject();
+        return out.flush();
     } catch (const std::exception& e) {
-        return json({{"success", false}, {"error", e.what()}}).dump();
+        return writeValue(out, json({{"success", false}, {"error", e.what()}}));
     }
 }
 
-std::string ApiHandler::handleProcessAssessment(const std::string& requestBody) {
+bool ApiHandler::handleProcessAssessment(const json& params, JsonStreamWriter& out) {
     try {
-        if (data_.empty()) {
-            return json({{"success", false}, {"error", "没有可用数据"}}).dump();
+        std::shared_lock<std::shared_mutex> lock(dataMutex_);
+        if (statistics_->data().empty()) {
+            return writeValue(out, json({{"success", false}, {"error", "没有可用数据"}}));
         }
         
-        json params = json::parse(requestBody);
         // 规格限
         double lsl = params.value("lsl", 70.0); // 下规格限
         double usl = params.value("usl", 130.0); // 上规格限
@@ -416,38 +758,39 @@ std::string ApiHandler::handleProcessAssessment(const std::string& requestBody)
         // 获取能力指数用于返回
         CapabilityIndices indices = statistics_->calculateCapabilityIndices(lsl, usl);
         
-        // 确保这些字段确实是字符串类型
-        std::string stabStatus = assessment.stabilityStatus;
-        std::string capLevel = assessment.capabilityLevel;
-        std::string recommendations = assessment.recommendations;
-        
-        return json({
-            {"success", true}, 
-            {"stabilityStatus", stabStatus},
-            {"capabilityLevel", capLevel},
-            {"recommendations", recommendations},
-            {"cp", indices.cp},
-            {"cpk", indices.cpk}
-        }).dump();
+        out.beginObject();
+        writeMembers(out, assessment);
+        out.key("cp").number(indices.cp);
+        out.key("cpk").number(indices.cpk);
+        out.key("success").boolean(true).endObject();
+        return out.flush();
     } catch (const json::exception& e) {
         // 专门处理JSON异常
-        return json({
+        return writeValue(out, json({
             {"success", false}, 
             {"error", std::string("JSON解析错误: ") + e.what()},
             {"errorType", "json_error"}
-        }).dump();
+        }));
     } catch (const std::exception& e) {
-        return json({{"success", false}, {"error", e.what()}}).dump();
+        return writeValue(out, json({{"success", false}, {"error", e.what()}}));
     }
 }
 
-std::string ApiHandler::handleAllAnalysis(const std::string& requestBody) {
+bool ApiHandler::streamAllAnalysis(const json& params, JsonStreamWriter& out) {
+    DescriptiveStats stats;
+    NormalityTest normalityTest;
+    MeanTest meanTest;
+    CapabilityIndices indices;
+    ControlChartData chartData;
+    ProcessAssessment assessment;
+    std::vector<double> histogram;
     try {
-        if (data_.empty()) {
-            return json({{"success", false}, {"error", "没有可用数据"}}).dump();
+        std::shared_lock<std::shared_mutex> lock(dataMutex_);
+        if (statistics_->data().empty()) {
+            out.value(json({{"success", false}, {"error", "没有可用数据"}}));
+            return out.flush();
         }
         
-        json params = json::parse(requestBody);
         // 规格限
         double lsl = params.value("lsl", 70.0); // 下规格限
         double usl = params.value("usl", 130.0); // 上规格限
@@ -455,161 +798,92 @@ std::string ApiHandler::handleAllAnalysis(const std::string& requestBody) {
         double alpha = params.value("alpha", 0.05);
         
         // 1. 描述性统计分析
-        DescriptiveStats stats = statistics_->calculateOverallStats();
+        stats = statistics_->calculateOverallStats();
         
         // 2. 正态性检验
-        NormalityTest normalityTest = statistics_->testNormality();
+        normalityTest = statistics_->testNormality();
         
         // 3. 均值检验
-        MeanTest meanTest = statistics_->testMean(expectedMean, alpha);
+        meanTest = statistics_->testMean(expectedMean, alpha);
         
         // 4. 计算能力指数
-        CapabilityIndices indices = statistics_->calculateCapabilityIndices(lsl, usl);
+        indices = statistics_->calculateCapabilityIndices(lsl, usl);
         
         // 5. 生成控制图数据
-        ControlChartData chartData = statistics_->generateControlChartData();
+        chartData = statistics_->generateControlChartData();
         
         // 6. 评估过程
-        ProcessAssessment assessment = statistics_->assessProcess(lsl, usl);
+        assessment = statistics_->assessProcess(lsl, usl);
         
         // 7. 生成直方图数据
-        std::vector<double> histogram = statistics_->generateHistogram();
-        
-        // 确保数组类型一致性
-        json histogramArray = json::array();
-        for (const auto& value : histogram) {
-            histogramArray.push_back(value);
-        }
-        
-        json meansArray = json::array();
-        for (const auto& mean : chartData.means) {
-            meansArray.push_back(mean);
-        }
-        
-        json rangesArray = json::array();
-        for (const auto& range : chartData.ranges) {
-            rangesArray.push_back(range);
-        }
-        
-        // 确保过程评估字段是字符串类型
-        std::string stabStatus = assessment.stabilityStatus;
-        std::string capLevel = assessment.capabilityLevel;
-        std::string recommendations = assessment.recommendations;
-        
-        // 确保正态性测试字段是字符串类型
-        std::string testMethod = normalityTest.testMethod;
-        std::string conclusion = normalityTest.conclusion;
-        
-        // 确保均值测试字段是字符串类型
-        std::string meanTestConclusion = meanTest.conclusion;
-        
-        // 构建完整的分析结果
-        json result = {
-            {"descriptiveStats", {
-                {"mean", stats.mean},
-                {"variance", stats.variance},
-                {"standardDeviation", stats.standardDeviation},
-                {"range", stats.range},
-                {"minimum", stats.minimum},
-                {"maximum", stats.maximum},
-                {"median", stats.median},
-                {"skewness", stats.skewness},
-                {"kurtosis", stats.kurtosis},
-                {"sampleSize", stats.sampleSize}
-            }},
-            {"normalityTest", {
-                {"isNormal", normalityTest.isNormal},
-                {"pValue", normalityTest.pValue},
-                {"statistic", normalityTest.statistic},
-                {"testMethod", testMethod},
-                {"conclusion", conclusion}
-            }},
-            {"meanTest", {
-                {"sampleMean", meanTest.sampleMean},
-                {"expectedMean", meanTest.expectedMean},
-                {"tStatistic", meanTest.tStatistic},
-                {"pValue", meanTest.pValue},
-                {"alpha", meanTest.alpha},
-                {"testResult", meanTest.testResult},
-                {"conclusion", meanTestConclusion}
-            }},
-            {"capabilityIndices", {
-                {"cp", indices.cp},
-                {"cpk", indices.cpk},
-                {"cpl", indices.cpl},
-                {"cpu", indices.cpu},
-                {"pp", indices.pp},
-                {"ppk", indices.ppk},
-                {"k", indices.k},
-                {"lsl", indices.lsl},
-                {"usl", indices.usl},
-                {"cpm", indices.cpm},
-                {"within", {
-                    {"sigma", indices.within.sigma},
-                    {"lowerZ", indices.within.lowerZ},
-                    {"upperZ", indices.within.upperZ}
-                }},
-                {"overall", {
-                    {"sigma", indices.overall.sigma},
-                    {"lowerZ", indices.overall.lowerZ},
-                    {"upperZ", indices.overall.upperZ}
-                }},
-                {"ppm", {
-                    {"expected", indices.ppm.expected},
-                    {"observed", indices.ppm.observed}
-                }}
-            }},
-            {"controlChart", {
-                {"means", meansArray},
-                {"ranges", rangesArray},
-                {"uclMean", chartData.uclMean},
-                {"lclMean", chartData.lclMean},
-                {"clMean", chartData.clMean},
-                {"uclRange", chartData.uclRange},
-                {"lclRange", chartData.lclRange},
-                {"clRange", chartData.clRange},
-                {"isControlled", chartData.isControlled},
-                {"outOfControlPoints", json::array()},
-                {"xbarChart", {
-                    {"centerLine", chartData.clMean},
-                    {"upperControlLimit", chartData.uclMean},
-                    {"lowerControlLimit", chartData.lclMean},
-                    {"values", meansArray},
-                    {"outOfControlPoints", json::array()}
-                }},
-                {"rChart", {
-                    {"centerLine", chartData.clRange},
-                    {"upperControlLimit", chartData.uclRange},
-                    {"lowerControlLimit", chartData.lclRange},
-                    {"values", rangesArray},
-                    {"outOfControlPoints", json::array()}
-                }}
-            }},
-            {"processAssessment", {
-                {"stabilityStatus", stabStatus},
-                {"capabilityLevel", capLevel},
-                {"recommendations", recommendations}
-            }},
-            {"histogram", histogramArray}
-        };
-        
-        // 返回标准化的响应格式
-        return json({{"success", true}, {"analysis", result}}).dump();
+        histogram = statistics_->generateHistogram();
     } catch (const json::exception& e) {
         // 专门捕获JSON异常并提供详细信息
-        return json({
+        out.value(json({
             {"success", false}, 
             {"error", std::string("JSON解析错误: ") + e.what()},
             {"errorType", "json_error"},
             {"errorId", e.id}
-        }).dump();
+        }));
+        return out.flush();
     } catch (const std::exception& e) {
         // 捕获所有其他异常
-        return json({
+        out.value(json({
             {"success", false}, 
             {"error", std::string("处理请求时发生错误: ") + e.what()}
-        }).dump();
+        }));
+        return out.flush();
     }
+    
+    // 计算在锁内完成，序列化在锁外进行，慢速客户端不会阻塞数据更新；
+    // 包含大数组的对象给出成员个数，MessagePack输出也能边生成边发送
+    out.beginObject(2).key("analysis").beginObject(7);
+    out.key("capabilityIndices").beginObject();
+    writeMembers(out, indices);
+    out.endObject();
+    out.key("controlChart").beginObject(12);
+    out.key("clMean").number(chartData.clMean);
+    out.key("clRange").number(chartData.clRange);
+    out.key("isControlled").boolean(chartData.isControlled);
+    out.key("lclMean").number(chartData.lclMean);
+    out.key("lclRange").number(chartData.lclRange);
+    out.key("means").numberArray(chartData.means);
+    out.key("outOfControlPoints").indexArray(chartData.outOfControlPoints);
+    out.key("rChart").beginObject(5);
+    out.key("centerLine").number(chartData.clRange);
+    out.key("lowerControlLimit").number(chartData.lclRange);
+    out.key("outOfControlPoints").indexArray(chartData.rangeOutOfControlPoints);
+    out.key("upperControlLimit").number(chartData.uclRange);
+    out.key("values").numberArray(chartData.ranges);
+    out.endObject();
+    out.key("ranges").numberArray(chartData.ranges);
+    out.key("uclMean").number(chartData.uclMean);
+    out.key("uclRange").number(chartData.uclRange);
+    out.key("xbarChart").beginObject(5);
+    out.key("centerLine").number(chartData.clMean);
+    out.key("lowerControlLimit").number(chartData.lclMean);
+    out.key("outOfControlPoints").indexArray(chartData.meanOutOfControlPoints);
+    out.key("upperControlLimit").number(chartData.uclMean);
+    out.key("values").numberArray(chartData.means);
+    out.endObject();
+    out.endObject();
+    out.key("descriptiveStats").beginObject();
+    writeMembers(out, stats);
+    out.endObject();
+    out.key("histogram").numberArray(histogram);
+    out.key("meanTest").beginObject();
+    writeMembers(out, meanTest);
+    out.endObject();
+    out.key("normalityTest").beginObject();
+    writeMembers(out, normalityTest);
+    out.endObject();
+    out.key("processAssessment").beginObject();
+    writeMembers(out, assessment);
+    out.endObject();
+    
+    // 返回标准化的响应格式
+    out.endObject().key("success").boolean(true).endObject();
+    return out.flush();
 }
 
 } // namespace QualityManagement
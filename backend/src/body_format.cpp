@@ -0,0 +1,136 @@
+#include "../include/body_format.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace QualityManagement {
+
+using json = nlohmann::json;
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 解析"application/cbor;q=0.5"中的q值，没有q参数时为1
+double qualityOf(std::string_view parameters) {
+    while (!parameters.empty()) {
+        size_t end = parameters.find(';');
+        std::string_view parameter = trim(parameters.substr(0, end));
+        if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+            return std::strtod(std::string(parameter.substr(2)).c_str(), nullptr);
+        }
+        parameters = end == std::string_view::npos ? std::string_view() : parameters.substr(end + 1);
+    }
+    return 1.0;
+}
+
+bool isCbor(std::string_view type) {
+    return equalsIgnoreCase(type, "application/cbor");
+}
+
+// MessagePack没有正式注册的媒体类型，常见的三种写法都接受
+bool isMessagePack(std::string_view type) {
+    return equalsIgnoreCase(type, "application/msgpack") || equalsIgnoreCase(type, "application/x-msgpack") ||
+           equalsIgnoreCase(type, "application/vnd.msgpack");
+}
+
+} // namespace
+
+BodyFormat requestBodyFormat(std::string_view contentType) {
+    std::string_view type = trim(contentType.substr(0, contentType.find(';')));
+    if (isCbor(type)) {
+        return BodyFormat::Cbor;
+    }
+    if (isMessagePack(type)) {
+        return BodyFormat::MessagePack;
+    }
+    return BodyFormat::Json;
+}
+
+BodyFormat negotiateBodyFormat(std::string_view accept) {
+    double jsonQuality = -1;   // 未出现时为-1
+    double wildcard = 0;
+    double cbor = 0;
+    double messagePack = 0;
+    while (!accept.empty()) {
+        size_t end = accept.find(',');
+        std::string_view item = accept.substr(0, end);
+        accept = end == std::string_view::npos ? std::string_view() : accept.substr(end + 1);
+
+        size_t semicolon = item.find(';');
+        std::string_view type = trim(item.substr(0, semicolon));
+        double quality = semicolon == std::string_view::npos ? 1.0 : qualityOf(item.substr(semicolon + 1));
+        if (isCbor(type)) {
+            cbor = quality;
+        } else if (isMessagePack(type)) {
+            messagePack = quality;
+        } else if (equalsIgnoreCase(type, "application/json")) {
+            jsonQuality = quality;
+        } else if (type == "*/*" || equalsIgnoreCase(type, "application/*")) {
+            wildcard = std::max(wildcard, quality);
+        }
+    }
+    if (jsonQuality < 0) {
+        jsonQuality = wildcard;
+    }
+    if (cbor > 0 && cbor >= messagePack && cbor >= jsonQuality) {
+        return BodyFormat::Cbor;
+    }
+    if (messagePack > 0 && messagePack >= jsonQuality) {
+        return BodyFormat::MessagePack;
+    }
+    return BodyFormat::Json;
+}
+
+const char* mediaType(BodyFormat format) {
+    switch (format) {
+    case BodyFormat::Cbor: return "application/cbor";
+    case BodyFormat::MessagePack: return "application/msgpack";
+    case BodyFormat::Json: break;
+    }
+    return "application/json";
+}
+
+json decodeBody(std::string_view body, BodyFormat format) {
+    if (body.empty()) {
+        return json::object();
+    }
+    switch (format) {
+    case BodyFormat::Cbor: return json::from_cbor(body.begin(), body.end());
+    case BodyFormat::MessagePack: return json::from_msgpack(body.begin(), body.end());
+    case BodyFormat::Json: break;
+    }
+    return json::parse(body);
+}
+
+std::string encodeValue(const json& value, BodyFormat format) {
+    std::string output;
+    switch (format) {
+    case BodyFormat::Cbor: json::to_cbor(value, output); break;
+    case BodyFormat::MessagePack: json::to_msgpack(value, output); break;
+    case BodyFormat::Json: output = value.dump(); break;
+    }
+    return output;
+}
+
+} // namespace QualityManagement
@@ -0,0 +1,142 @@
+#include "../include/compression.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace QualityManagement {
+
+namespace {
+
+const size_t kOutputStep = 16384;    // 每次为压缩输出扩展的空间
+const size_t kMaxInput = 1u << 30;   // avail_in是32位，超大输入分段送入
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 解析"gzip;q=0.5"中的q值，没有q参数时为1
+double qualityOf(std::string_view parameters) {
+    while (!parameters.empty()) {
+        size_t end = parameters.find(';');
+        std::string_view parameter = trim(parameters.substr(0, end));
+        if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+            return std::strtod(std::string(parameter.substr(2)).c_str(), nullptr);
+        }
+        parameters = end == std::string_view::npos ? std::string_view() : parameters.substr(end + 1);
+    }
+    return 1.0;
+}
+
+} // namespace
+
+ContentEncoding negotiateEncoding(std::string_view acceptEncoding) {
+    double gzip = 0;
+    double deflate = 0;
+    double wildcard = -1;      // 未出现*时为-1
+    while (!acceptEncoding.empty()) {
+        size_t end = acceptEncoding.find(',');
+        std::string_view item = acceptEncoding.substr(0, end);
+        acceptEncoding = end == std::string_view::npos ? std::string_view() : acceptEncoding.substr(end + 1);
+
+        size_t semicolon = item.find(';');
+        std::string_view coding = trim(item.substr(0, semicolon));
+        double quality = semicolon == std::string_view::npos ? 1.0 : qualityOf(item.substr(semicolon + 1));
+        if (equalsIgnoreCase(coding, "gzip") || equalsIgnoreCase(coding, "x-gzip")) {
+            gzip = quality;
+        } else if (equalsIgnoreCase(coding, "deflate")) {
+            deflate = quality;
+        } else if (coding == "*") {
+            wildcard = quality;
+        }
+    }
+    if (wildcard > 0 && gzip == 0 && deflate == 0) {
+        gzip = wildcard;
+    }
+    if (gzip > 0 && gzip >= deflate) {
+        return ContentEncoding::Gzip;
+    }
+    return deflate > 0 ? ContentEncoding::Deflate : ContentEncoding::Identity;
+}
+
+std::string contentEncodingHeader(ContentEncoding encoding) {
+    switch (encoding) {
+    case ContentEncoding::Gzip: return "Content-Encoding: gzip\r\n";
+    case ContentEncoding::Deflate: return "Content-Encoding: deflate\r\n";
+    case ContentEncoding::Identity: break;
+    }
+    return std::string();
+}
+
+Compressor::Compressor(ContentEncoding encoding, int level) {
+    // windowBits加16输出gzip头尾，否则为zlib格式
+    int windowBits = encoding == ContentEncoding::Gzip ? 15 + 16 : 15;
+    if (deflateInit2(&stream_, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("初始化zlib压缩失败");
+    }
+}
+
+Compressor::~Compressor() {
+    deflateEnd(&stream_);
+}
+
+void Compressor::compress(std::string_view input, bool finish, std::string& output) {
+    if (finished_) {
+        return;
+    }
+    while (input.size() > kMaxInput) {
+        compress(input.substr(0, kMaxInput), false, output);
+        input.remove_prefix(kMaxInput);
+    }
+    stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream_.avail_in = static_cast<uInt>(input.size());
+    int flush = finish ? Z_FINISH : Z_NO_FLUSH;
+    while (true) {
+        size_t used = output.size();
+        size_t room = std::max<size_t>(kOutputStep, deflateBound(&stream_, stream_.avail_in) / 4);
+        output.resize(used + room);
+        stream_.next_out = reinterpret_cast<Bytef*>(&output[used]);
+        stream_.avail_out = static_cast<uInt>(room);
+        int status = deflate(&stream_, flush);
+        output.resize(used + room - stream_.avail_out);
+        if (status == Z_STREAM_END) {
+            finished_ = true;
+            return;
+        }
+        if (status != Z_OK && status != Z_BUF_ERROR) {
+            throw std::runtime_error("zlib压缩失败");
+        }
+        // 输入已全部消耗且输出缓冲没有被填满，说明本次没有更多输出
+        if (stream_.avail_in == 0 && stream_.avail_out != 0 && !finish) {
+            return;
+        }
+    }
+}
+
+std::string compressBody(std::string_view body, ContentEncoding encoding, int level) {
+    Compressor compressor(encoding, level);
+    std::string output;
+    output.reserve(deflateBound(nullptr, static_cast<uLong>(body.size())) / 4 + 64);
+    compressor.compress(body, true, output);
+    return output;
+}
+
+} // namespace QualityManagement
@@ -0,0 +1,48 @@
+#include "../include/control_chart_feed.h"
+#include <algorithm>
+
+namespace QualityManagement {
+
+void ControlChartFeed::subscribe(Subscriber subscriber, Liveness alive) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 在锁内检查：连接关闭时先置alive再调用prune，两者之间登记的订阅者也会被发现
+    if (alive->load(std::memory_order_acquire)) {
+        subscribers_.push_back({std::move(subscriber), std::move(alive)});
+    }
+}
+
+void ControlChartFeed::publish(const std::string& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+                                      [&event](const Entry& entry) {
+                                          return !entry.alive->load(std::memory_order_acquire) ||
+                                                 !entry.subscriber(event);
+                                      }),
+                       subscribers_.end());
+}
+
+void ControlChartFeed::prune() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+                                      [](const Entry& entry) { return !entry.alive->load(std::memory_order_acquire); }),
+                       subscribers_.end());
+}
+
+bool ControlChartFeed::hasSubscribers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !subscribers_.empty();
+}
+
+std::string ControlChartFeed::encodeEvent(const char* type, const std::string& data) {
+    // JSON序列化结果不含换行，整个载荷放在一行data中
+    std::string event;
+    event.reserve(data.size() + 32);
+    event += "event: ";
+    event += type;
+    event += "\ndata: ";
+    event += data;
+    event += "\n\n";
+    return event;
+}
+
+} // namespace QualityManagement
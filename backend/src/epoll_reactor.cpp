@@ -0,0 +1,285 @@
+#include "../include/epoll_reactor.h"
+#include <algorithm>
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace QualityManagement {
+
+namespace {
+
+const int kMaxEvents = 256;         // 单次epoll_wait返回的最大事件数
+const int kMaxReadsPerEvent = 8;    // 单次就绪最多接收的次数，每次不超过readChunkSize字节
+
+} // namespace
+
+EpollReactor::~EpollReactor() {
+    if (wakeFd_ >= 0) {
+        close(wakeFd_);
+    }
+    if (epollFd_ >= 0) {
+        close(epollFd_);
+    }
+}
+
+bool EpollReactor::init() {
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) {
+        std::cerr << "创建epoll实例失败: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // eventfd用于从其他线程唤醒阻塞在epoll_wait中的事件循环
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) {
+        std::cerr << "创建eventfd失败: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = wakeFd_;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev) < 0) {
+        std::cerr << "注册eventfd失败: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // 监听套接字可能被多个Reactor共享，EPOLLEXCLUSIVE避免一个连接唤醒所有线程
+    for (int listenFd : listenFds_) {
+        ev.events = EPOLLIN | EPOLLET | EPOLLEXCLUSIVE;
+        ev.data.fd = listenFd;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd, &ev) < 0) {
+            std::cerr << "注册监听套接字失败: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+
+    running_.store(true, std::memory_order_release);
+    return true;
+}
+
+void EpollReactor::run() {
+    epoll_event events[kMaxEvents];
+
+    while (running_.load(std::memory_order_acquire)) {
+        // 有连接在计时时按时间轮刻度醒来，否则一直等待事件
+        int timeout = timers_.empty() ? -1 : static_cast<int>(timers_.tickMs());
+        int count = epoll_wait(epollFd_, events, kMaxEvents, timeout);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "epoll_wait失败: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            uint32_t flags = events[i].events;
+
+            if (fd == wakeFd_) {
+                uint64_t value;
+                while (read(wakeFd_, &value, sizeof(value)) > 0) {
+                }
+                handleCompletions();
+                continue;
+            }
+
+            if (isListener(fd)) {
+                handleAccept(fd);
+                continue;
+            }
+
+            auto it = connections_.find(fd);
+            if (it == connections_.end()) {
+                continue;
+            }
+            Connection& conn = *it->second;
+
+            if ((flags & (EPOLLERR | EPOLLHUP)) && !(flags & EPOLLIN)) {
+                closeConnection(fd);
+                continue;
+            }
+            if ((flags & EPOLLIN) && !handleRead(conn)) {
+                closeConnection(fd);
+                continue;
+            }
+            if ((flags & EPOLLOUT) && !handleWrite(conn)) {
+                closeConnection(fd);
+            }
+        }
+
+        expireTimers();
+        if (draining_.load(std::memory_order_acquire) && drainComplete()) {
+            break;
+        }
+    }
+
+    for (auto& entry : connections_) {
+        close(entry.first);
+    }
+    connections_.clear();
+    finished_.store(true, std::memory_order_release);
+}
+
+void EpollReactor::wakeup() {
+    uint64_t one = 1;
+    if (write(wakeFd_, &one, sizeof(one)) < 0) {
+        // eventfd计数已满时同样能唤醒事件循环，忽略错误
+    }
+}
+
+void EpollReactor::handleAccept(int listenFd) {
+    // 边缘触发模式下必须一直accept直到EAGAIN
+    while (true) {
+        sockaddr_storage clientAddress{};
+        socklen_t clientAddressSize = sizeof(clientAddress);
+        int fd = accept4(listenFd, reinterpret_cast<sockaddr*>(&clientAddress), &clientAddressSize,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            // 停止期间监听套接字被关闭，accept返回EINVAL
+            if (errno != EAGAIN && errno != EWOULDBLOCK && !draining_.load(std::memory_order_acquire)) {
+                std::cerr << "接受客户端连接失败: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        // 读写事件一次性注册，边缘触发下可写事件只在状态变化时通知
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = fd;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            std::cerr << "注册客户端连接失败: " << std::strerror(errno) << std::endl;
+            close(fd);
+            continue;
+        }
+
+        addConnection(fd, reinterpret_cast<sockaddr*>(&clientAddress), clientAddressSize);
+    }
+}
+
+void EpollReactor::stopAccepting() {
+    for (int listenFd : listenFds_) {
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, listenFd, nullptr);
+    }
+}
+
+bool EpollReactor::handleRead(Connection& conn) {
+    // 请求计算期间缓冲被工作线程引用，不能写入或移动；
+    // 数据留在内核缓冲中，请求完成后再主动读取
+    if (conn.busy) {
+        return true;
+    }
+
+    // 请求完成后恢复接收时，缓冲中可能已有完整的后续请求（流水线），先处理它们
+    processRequests(conn);
+
+    // 每次接收后立即解析：请求头超限在多读一块之内就能发现，暂存的请求体随即写入临时文件，
+    // 接收缓冲的占用与客户端发送的总量无关。单次就绪最多接收kMaxReadsPerEvent次，
+    // 发送很快的客户端不会独占事件循环。请求开始计算后缓冲被工作线程引用，
+    // 剩余数据留在内核缓冲中，请求完成后再读取
+    int reads = 0;
+    while (!conn.busy) {
+        if (conn.closeAfterWrite) {
+            // 出错或已请求关闭，后续数据不再处理
+            discardInput(conn);
+        }
+        if (reads == kMaxReadsPerEvent) {
+            // 数据可能还没读完，边缘触发下不会再次通知，重新登记让epoll在下一轮再报告就绪
+            rearm(conn);
+            break;
+        }
+
+        size_t chunk = options_.readChunkSize;
+        char* target = conn.input->prepare(chunk);
+        ssize_t received = recv(conn.fd, target, std::min(conn.input->writable(), chunk), 0);
+        if (received > 0) {
+            ++reads;
+            conn.input->commit(received);
+            processRequests(conn);
+            continue;
+        }
+
+        if (received == 0) {
+            // 对端关闭写方向后，仍然处理并回复已完整到达的请求
+            conn.peerClosed = true;
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        std::cerr << "接收数据失败: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    return handleWrite(conn);
+}
+
+void EpollReactor::rearm(Connection& conn) {
+    // 边缘触发下EPOLL_CTL_MOD会重新检查就绪状态，仍有数据可读时立即产生新的事件
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.fd = conn.fd;
+    epoll_ctl(epollFd_, EPOLL_CTL_MOD, conn.fd, &ev);
+}
+
+bool EpollReactor::handleWrite(Connection& conn) {
+    size_t pending = conn.output.pendingBytes();
+    OutputQueue::WriteResult result = conn.output.writeTo(conn.fd);
+    if (result == OutputQueue::WriteResult::Error) {
+        return false;
+    }
+    if (conn.output.pendingBytes() != pending) {
+        reportWriteProgress(conn);
+    }
+    if (result == OutputQueue::WriteResult::WouldBlock) {
+        // 发送缓冲区已满，等待EPOLLOUT后从断点继续
+        return true;
+    }
+
+    // 响应全部发出且没有进行中的请求时，按需关闭连接
+    if (!conn.busy && (conn.closeAfterWrite || conn.peerClosed)) {
+        return false;
+    }
+    return true;
+}
+
+void EpollReactor::resumeConnection(Connection& conn) {
+    if (!handleRead(conn)) {
+        closeConnection(conn.fd);
+    }
+}
+
+void EpollReactor::flushConnection(Connection& conn) {
+    if (!handleWrite(conn)) {
+        closeConnection(conn.fd);
+    }
+}
+
+void EpollReactor::discardInput(Connection& conn) {
+    // 接收只在本线程中同步进行，缓冲可以立即清空
+    conn.input->consume(conn.input->size());
+}
+
+void EpollReactor::closeConnection(int fd) {
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections_.erase(fd);
+}
+
+} // namespace QualityManagement
@@ -0,0 +1,21 @@
+#include "../include/grouped_data.h"
+
+namespace QualityManagement {
+
+void GroupedData::closeGroup() {
+    if (values_.size() > offsets_.back()) {
+        offsets_.push_back(values_.size());
+    }
+}
+
+void GroupedData::appendGroup(SampleSpan group) {
+    values_.insert(values_.end(), group.begin(), group.end());
+    closeGroup();
+}
+
+void GroupedData::clear() {
+    values_.clear();
+    offsets_.assign(1, 0);
+}
+
+} // namespace QualityManagement
@@ -0,0 +1,220 @@
+#include "../include/http_parser.h"
+#include <cstring>
+
+namespace QualityManagement {
+
+namespace {
+
+const size_t kMaxHeaderSize = 64 * 1024;   // 请求行加请求头的最大长度
+
+// 不区分大小写比较
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        char x = a[i];
+        char y = b[i];
+        if (x >= 'A' && x <= 'Z') x += 'a' - 'A';
+        if (y >= 'A' && y <= 'Z') y += 'a' - 'A';
+        if (x != y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 去除首尾空白
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+} // namespace
+
+HttpParser::HttpParser(size_t maxBodySize) : maxBodySize_(maxBodySize) {
+}
+
+void HttpParser::reset() {
+    state_ = State::RequestLine;
+    scanOffset_ = 0;
+    lineStart_ = 0;
+    method_ = Span();
+    path_ = Span();
+    version_ = Span();
+    bodyStart_ = 0;
+    contentLength_ = 0;
+    contentLengthSeen_ = false;
+    keepAlive_ = true;
+    realIp_ = Span();
+    acceptEncoding_ = Span();
+    contentType_ = Span();
+    accept_ = Span();
+}
+
+ParseStatus HttpParser::fail(const char* status, const std::string& message) {
+    errorStatus_ = status;
+    errorMessage_ = message;
+    return ParseStatus::Error;
+}
+
+ParseStatus HttpParser::parse(std::string_view data, HttpRequest& request) {
+    // 逐行处理请求行和请求头，只扫描新到达的字节
+    while (state_ != State::Body) {
+        const void* found = nullptr;
+        if (scanOffset_ < data.size()) {
+            found = std::memchr(data.data() + scanOffset_, '\n', data.size() - scanOffset_);
+        }
+        if (found == nullptr) {
+            scanOffset_ = data.size();
+            if (scanOffset_ > kMaxHeaderSize) {
+                return fail("431 Request Header Fields Too Large", "请求头过大");
+            }
+            return ParseStatus::Incomplete;
+        }
+
+        size_t lineEnd = static_cast<const char*>(found) - data.data();
+        std::string_view line = data.substr(lineStart_, lineEnd - lineStart_);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        scanOffset_ = lineEnd + 1;
+        // 每一行都检查累计长度：客户端每次恰好发送完整的行时，上面未找到换行的分支不会执行
+        if (scanOffset_ > kMaxHeaderSize) {
+            return fail("431 Request Header Fields Too Large", "请求头过大");
+        }
+
+        if (state_ == State::RequestLine) {
+            // 容忍请求之间多余的空行
+            if (!line.empty()) {
+                if (!parseRequestLine(line)) {
+                    return ParseStatus::Error;
+                }
+                state_ = State::Headers;
+            }
+        } else if (line.empty()) {
+            // 空行表示请求头结束
+            state_ = State::Body;
+            bodyStart_ = scanOffset_;
+        } else if (!parseHeaderLine(line)) {
+            return ParseStatus::Error;
+        }
+        lineStart_ = scanOffset_;
+    }
+
+    // 按Content-Length等待请求体接收完整
+    if (data.size() < bodyStart_ + contentLength_) {
+        return ParseStatus::Incomplete;
+    }
+
+    fillHeaders(data, request);
+    request.body = data.substr(bodyStart_, contentLength_);
+    return ParseStatus::Complete;
+}
+
+bool HttpParser::peekHeaders(std::string_view data, HttpRequest& request) const {
+    if (state_ != State::Body) {
+        return false;
+    }
+    fillHeaders(data, request);
+    request.body = std::string_view();
+    return true;
+}
+
+void HttpParser::fillHeaders(std::string_view data, HttpRequest& request) const {
+    request.method = data.substr(method_.offset, method_.length);
+    request.path = data.substr(path_.offset, path_.length);
+    request.version = data.substr(version_.offset, version_.length);
+    request.realIp = data.substr(realIp_.offset, realIp_.length);
+    request.acceptEncoding = data.substr(acceptEncoding_.offset, acceptEncoding_.length);
+    request.contentType = data.substr(contentType_.offset, contentType_.length);
+    request.accept = data.substr(accept_.offset, accept_.length);
+    request.contentLength = contentLength_;
+    request.keepAlive = keepAlive_;
+}
+
+bool HttpParser::parseRequestLine(std::string_view line) {
+    // 提取请求行中的方法、路径和HTTP版本
+    size_t methodEnd = line.find(' ');
+    size_t pathEnd = methodEnd == std::string_view::npos ? methodEnd : line.find(' ', methodEnd + 1);
+    if (methodEnd == 0 || pathEnd == std::string_view::npos || pathEnd == methodEnd + 1) {
+        fail("400 Bad Request", "无效的请求行");
+        return false;
+    }
+
+    method_ = {lineStart_, methodEnd};
+    path_ = {lineStart_ + methodEnd + 1, pathEnd - methodEnd - 1};
+    version_ = {lineStart_ + pathEnd + 1, line.size() - pathEnd - 1};
+
+    std::string_view version = line.substr(pathEnd + 1);
+    if (version == "HTTP/1.0") {
+        keepAlive_ = false;
+    } else if (version != "HTTP/1.1") {
+        fail("505 HTTP Version Not Supported", "不支持的HTTP版本");
+        return false;
+    }
+    return true;
+}
+
+bool HttpParser::parseHeaderLine(std::string_view line) {
+    size_t colon = line.find(':');
+    if (colon == std::string_view::npos || colon == 0) {
+        fail("400 Bad Request", "无效的请求头");
+        return false;
+    }
+
+    std::string_view name = line.substr(0, colon);
+    std::string_view value = trim(line.substr(colon + 1));
+
+    if (equalsIgnoreCase(name, "Content-Length")) {
+        // 重复的Content-Length（即使取值相同）一律拒绝：前置代理与本服务若各取其一，
+        // 请求边界就会不一致（RFC 9112 6.3节）
+        if (contentLengthSeen_) {
+            fail("400 Bad Request", "重复的Content-Length");
+            return false;
+        }
+        contentLengthSeen_ = true;
+        if (value.empty() || value.size() > 18) {
+            fail("400 Bad Request", "无效的Content-Length");
+            return false;
+        }
+        size_t length = 0;
+        for (char c : value) {
+            if (c < '0' || c > '9') {
+                fail("400 Bad Request", "无效的Content-Length");
+                return false;
+            }
+            length = length * 10 + (c - '0');
+        }
+        if (length > maxBodySize_) {
+            fail("413 Payload Too Large", "请求体超过大小限制");
+            return false;
+        }
+        contentLength_ = length;
+    } else if (equalsIgnoreCase(name, "Connection")) {
+        if (equalsIgnoreCase(value, "close")) {
+            keepAlive_ = false;
+        } else if (equalsIgnoreCase(value, "keep-alive")) {
+            keepAlive_ = true;
+        }
+    } else if (equalsIgnoreCase(name, "X-Real-IP")) {
+        realIp_ = {lineStart_ + static_cast<size_t>(value.data() - line.data()), value.size()};
+    } else if (equalsIgnoreCase(name, "Accept-Encoding")) {
+        acceptEncoding_ = {lineStart_ + static_cast<size_t>(value.data() - line.data()), value.size()};
+    } else if (equalsIgnoreCase(name, "Content-Type")) {
+        contentType_ = {lineStart_ + static_cast<size_t>(value.data() - line.data()), value.size()};
+    } else if (equalsIgnoreCase(name, "Accept")) {
+        accept_ = {lineStart_ + static_cast<size_t>(value.data() - line.data()), value.size()};
+    } else if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+        fail("501 Not Implemented", "不支持分块传输的请求体");
+        return false;
+    }
+    return true;
+}
+
+} // namespace QualityManagement
@@ -0,0 +1,76 @@
+#include "../include/http_response.h"
+#include <cstdio>
+
+namespace QualityManagement {
+
+namespace {
+
+std::string renderHeader(const std::string& framing, bool keepAlive, const char* status,
+                         const char* contentType = "application/json") {
+    std::string header;
+    header.reserve(256);
+    header += "HTTP/1.1 ";
+    header += status;
+    header += "\r\n";
+    header += "Content-Type: ";
+    header += contentType;
+    header += "\r\n";
+    header += "Access-Control-Allow-Origin: *\r\n";  // 允许跨域请求
+    header += "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n";
+    header += "Access-Control-Allow-Headers: Content-Type\r\n";
+    header += framing;
+    header += keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    header += "\r\n";
+    return header;
+}
+
+} // namespace
+
+std::string renderResponseHeader(size_t contentLength, bool keepAlive, const char* status,
+                                 const std::string& extraHeaders, const char* contentType) {
+    return renderHeader("Content-Length: " + std::to_string(contentLength) + "\r\n" + extraHeaders,
+                        keepAlive, status, contentType);
+}
+
+std::string renderChunkedHeader(bool keepAlive, const char* status, const std::string& extraHeaders,
+                                const char* contentType) {
+    return renderHeader("Transfer-Encoding: chunked\r\n" + extraHeaders, keepAlive, status, contentType);
+}
+
+std::string renderVaryHeader(bool acceptEncoding) {
+    return acceptEncoding ? "Vary: Accept, Accept-Encoding\r\n" : "Vary: Accept\r\n";
+}
+
+std::string renderEventStreamHeader() {
+    // X-Accel-Buffering使nginx逐个转发事件而不是攒满缓冲
+    std::string header;
+    header.reserve(256);
+    header += "HTTP/1.1 200 OK\r\n";
+    header += "Content-Type: text/event-stream\r\n";
+    header += "Cache-Control: no-cache\r\n";
+    header += "X-Accel-Buffering: no\r\n";
+    header += "Access-Control-Allow-Origin: *\r\n";
+    header += "Connection: close\r\n";
+    header += "\r\n";
+    return header;
+}
+
+std::string renderChunkPrefix(size_t chunkSize, bool first) {
+    char line[32];
+    int length = std::snprintf(line, sizeof(line), first ? "%zx\r\n" : "\r\n%zx\r\n", chunkSize);
+    return std::string(line, length);
+}
+
+std::string renderLastChunk(bool first) {
+    return first ? "0\r\n\r\n" : "\r\n0\r\n\r\n";
+}
+
+HttpResponse makeJsonResponse(std::string body, bool keepAlive, const char* status,
+                              const std::string& extraHeaders) {
+    HttpResponse response;
+    response.header = renderResponseHeader(body.size(), keepAlive, status, extraHeaders);
+    response.body = std::move(body);
+    return response;
+}
+
+} // namespace QualityManagement
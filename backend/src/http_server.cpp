@@ -0,0 +1,317 @@
+#include "../include/http_server.h"
+#include "../include/epoll_reactor.h"
+#include "../include/io_uring.h"
+#include "../include/uring_reactor.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+namespace QualityManagement {
+
+namespace {
+
+// 优雅停止的期限已过时，仍给正在执行的计算任务留出的最短等待时间
+const int kMinTaskGraceMs = 500;
+
+} // namespace
+
+HttpServer::HttpServer(ApiHandler& apiHandler, const ServerOptions& options)
+    : apiHandler_(apiHandler), options_(options) {
+}
+
+HttpServer::~HttpServer() {
+    stop();
+}
+
+int HttpServer::openListener(bool reusePort) {
+    // 创建非阻塞的服务器套接字
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (fd < 0) {
+        std::cerr << "创建套接字失败: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // SO_REUSEPORT允许多个套接字绑定同一端口，由内核按连接哈希分发
+    if (reusePort && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) < 0) {
+        std::cerr << "设置SO_REUSEPORT失败: " << std::strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+
+    // 配置服务器地址
+    sockaddr_in serverAddress{};
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_port = htons(options_.port);
+    if (inet_pton(AF_INET, options_.bindAddress.c_str(), &serverAddress.sin_addr) != 1) {
+        std::cerr << "无效的监听地址: " << options_.bindAddress << std::endl;
+        close(fd);
+        return -1;
+    }
+
+    // 绑定套接字
+    if (bind(fd, reinterpret_cast<sockaddr*>(&serverAddress), sizeof(serverAddress)) < 0) {
+        std::cerr << "绑定套接字失败: " << std::strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+
+    // 开始监听
+    if (listen(fd, SOMAXCONN) < 0) {
+        std::cerr << "监听套接字失败: " << std::strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+int HttpServer::openUnixListener() {
+    sockaddr_un serverAddress{};
+    if (options_.unixSocketPath.size() >= sizeof(serverAddress.sun_path)) {
+        std::cerr << "Unix域套接字路径过长: " << options_.unixSocketPath << std::endl;
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "创建Unix域套接字失败: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    // 上次异常退出留下的套接字文件会使bind失败，先删除
+    unlink(options_.unixSocketPath.c_str());
+    serverAddress.sun_family = AF_UNIX;
+    std::memcpy(serverAddress.sun_path, options_.unixSocketPath.c_str(), options_.unixSocketPath.size() + 1);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&serverAddress), sizeof(serverAddress)) < 0) {
+        std::cerr << "绑定Unix域套接字失败: " << options_.unixSocketPath << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+
+    // nginx工作进程通常以其他用户运行，需要写权限才能连接
+    chmod(options_.unixSocketPath.c_str(), 0666);
+
+    if (listen(fd, SOMAXCONN) < 0) {
+        std::cerr << "监听Unix域套接字失败: " << std::strerror(errno) << std::endl;
+        close(fd);
+        unlink(options_.unixSocketPath.c_str());
+        return -1;
+    }
+    return fd;
+}
+
+bool HttpServer::start() {
+    int cpuCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int threadCount = options_.ioThreads > 0 ? options_.ioThreads : cpuCount;
+    int workerCount = options_.workerThreads > 0 ? options_.workerThreads : cpuCount;
+    size_t queueDepth = static_cast<size_t>(std::max(1, options_.workerQueueDepth));
+
+    // 分片模式下每个Reactor独占一个监听套接字；否则所有Reactor共享一个
+    int listenerCount = options_.reusePort ? threadCount : 1;
+    for (int i = 0; i < listenerCount; ++i) {
+        int fd = openListener(options_.reusePort);
+        if (fd < 0) {
+            stop();
+            return false;
+        }
+        listenFds_.push_back(fd);
+    }
+
+    // Unix域套接字由所有Reactor共享
+    if (!options_.unixSocketPath.empty()) {
+        unixListenFd_ = openUnixListener();
+        if (unixListenFd_ < 0) {
+            stop();
+            return false;
+        }
+    }
+
+    // 计算线程池数量固定为核心数，CPU密集任务不会随连接数增长
+    computePool_ = std::make_unique<ThreadPool>(workerCount, queueDepth);
+    admission_ = std::make_unique<AdmissionController>(options_.admissionBudget);
+    rateLimiter_ = std::make_unique<RateLimiter>(static_cast<uint32_t>(std::max(0, options_.rateLimitRps)),
+                                                 static_cast<uint32_t>(std::max(1, options_.rateLimitBurst)));
+    jobs_ = std::make_unique<JobManager>(static_cast<uint64_t>(options_.jobTtlSeconds) * 1000,
+                                         static_cast<size_t>(options_.maxJobs));
+    coalescer_ = std::make_unique<RequestCoalescer>();
+
+    // io_uring在运行时探测，内核过旧或被seccomp禁用时回退到epoll
+    bool useUring = false;
+    if (options_.ioBackend == IoBackend::IoUring) {
+        useUring = IoUring::isSupported();
+        if (!useUring) {
+            std::cerr << "当前内核不支持io_uring，回退到epoll" << std::endl;
+        }
+    }
+
+    for (int i = 0; i < threadCount; ++i) {
+        std::vector<int> reactorFds{listenFds_[i % listenFds_.size()]};
+        if (unixListenFd_ >= 0) {
+            reactorFds.push_back(unixListenFd_);
+        }
+        auto reactor = createReactor(reactorFds, useUring);
+        if (!reactor->init()) {
+            if (!useUring || i > 0) {
+                stop();
+                return false;
+            }
+            // 首个io_uring实例就创建失败（如内存锁定限制），整体改用epoll
+            std::cerr << "初始化io_uring失败，回退到epoll" << std::endl;
+            useUring = false;
+            reactor = createReactor(reactorFds, useUring);
+            if (!reactor->init()) {
+                stop();
+                return false;
+            }
+        }
+        reactors_.push_back(std::move(reactor));
+    }
+
+    for (int i = 0; i < threadCount; ++i) {
+        threads_.emplace_back(&Reactor::run, reactors_[i].get());
+        if (options_.reusePort) {
+            pinThread(threads_.back(), i % cpuCount);
+        }
+    }
+
+    std::cout << "服务器已启动，监听" << options_.bindAddress << ":" << options_.port
+              << (unixListenFd_ >= 0 ? "及Unix域套接字" + options_.unixSocketPath : "")
+              << "，事件循环线程数: " << threadCount
+              << (options_.reusePort ? "（SO_REUSEPORT分片）" : "")
+              << "，I/O后端: " << (useUring ? "io_uring" : "epoll")
+              << "，计算线程数: " << workerCount
+              << "，任务队列上限: " << queueDepth
+              << "，准入预算: " << (options_.admissionBudget > 0 ? std::to_string(options_.admissionBudget) : "不限")
+              << "，限流: " << (options_.rateLimitRps > 0
+                                 ? std::to_string(options_.rateLimitRps) + "令牌/秒，容量" + std::to_string(options_.rateLimitBurst)
+                                 : "关闭")
+              << std::endl;
+    return true;
+}
+
+bool HttpServer::drain() {
+    for (auto& reactor : reactors_) {
+        reactor->beginDrain();
+    }
+    // 监听套接字不再接受连接：新连接立即被拒绝，由客户端或负载均衡重试其他实例，
+    // 而不是在积压队列中等到进程退出
+    for (int fd : listenFds_) {
+        shutdown(fd, SHUT_RD);
+    }
+    if (unixListenFd_ >= 0) {
+        unlink(options_.unixSocketPath.c_str());
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options_.drainTimeoutMs);
+    drainDeadline_ = deadline;
+    while (true) {
+        bool finished = std::all_of(reactors_.begin(), reactors_.end(),
+                                    [](const std::unique_ptr<Reactor>& reactor) { return reactor->finished(); });
+        if (finished) {
+            return true;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            std::cerr << "等待进行中的请求超时，强制关闭剩余连接" << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+}
+
+bool HttpServer::stop() {
+    for (auto& reactor : reactors_) {
+        reactor->stop();
+    }
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+
+    // 事件循环已停止，排队的任务结果无法再送达客户端，直接丢弃；
+    // 只等正在执行的任务结束，它们完成时仍会访问Reactor
+    bool finished = true;
+    if (computePool_) {
+        auto now = std::chrono::steady_clock::now();
+        auto deadline = drainDeadline_ != std::chrono::steady_clock::time_point{}
+                            ? drainDeadline_
+                            : now + std::chrono::milliseconds(options_.drainTimeoutMs);
+        auto timeout = std::max(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now),
+                                std::chrono::milliseconds(kMinTaskGraceMs));
+        size_t discarded = 0;
+        finished = computePool_->shutdownFor(timeout, discarded);
+        size_t cancelled = jobs_ ? jobs_->cancelQueued() : 0;
+        if (discarded > 0) {
+            std::cerr << "丢弃" << discarded << "个未执行的计算任务，其中异步任务" << cancelled << "个" << std::endl;
+        }
+    }
+    if (finished) {
+        reactors_.clear();
+        computePool_.reset();
+        admission_.reset();
+        rateLimiter_.reset();
+        jobs_.reset();
+        coalescer_.reset();
+    } else {
+        // 超时仍在执行的任务还会访问线程池、Reactor和任务管理器，这些对象不再释放，
+        // 由随后的进程退出回收
+        std::cerr << "计算任务在停止期限内未结束，放弃等待" << std::endl;
+        for (auto& reactor : reactors_) {
+            reactor.release();
+        }
+        reactors_.clear();
+        computePool_.release();
+        admission_.release();
+        rateLimiter_.release();
+        jobs_.release();
+        coalescer_.release();
+    }
+
+    for (int fd : listenFds_) {
+        close(fd);
+    }
+    listenFds_.clear();
+    if (unixListenFd_ >= 0) {
+        close(unixListenFd_);
+        unlink(options_.unixSocketPath.c_str());
+        unixListenFd_ = -1;
+    }
+    return finished;
+}
+
+std::unique_ptr<Reactor> HttpServer::createReactor(std::vector<int> listenFds, bool useUring) {
+    if (useUring) {
+        return std::make_unique<UringReactor>(apiHandler_, *computePool_, *admission_, *rateLimiter_, *jobs_,
+                                              *coalescer_, std::move(listenFds), options_);
+    }
+    return std::make_unique<EpollReactor>(apiHandler_, *computePool_, *admission_, *rateLimiter_, *jobs_,
+                                          *coalescer_, std::move(listenFds), options_);
+}
+
+void HttpServer::pinThread(std::thread& thread, int core) {
+    // 绑定CPU核心，连接的接受、解析和发送始终留在同一核心的缓存中
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    int result = pthread_setaffinity_np(thread.native_handle(), sizeof(cpuset), &cpuset);
+    if (result != 0) {
+        std::cerr << "绑定事件循环线程到CPU" << core << "失败: " << std::strerror(result) << std::endl;
+    }
+}
+
+} // namespace QualityManagement
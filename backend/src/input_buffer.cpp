@@ -0,0 +1,69 @@
+#include "../include/input_buffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace QualityManagement {
+
+namespace {
+
+const size_t kInitialCapacity = 16384;             // 首次分配的缓冲大小
+const size_t kRetainCapacity = 1024 * 1024;        // 缓冲清空后保留的最大容量
+
+} // namespace
+
+char* InputBuffer::prepare(size_t minWritable) {
+    if (writable() >= minWritable) {
+        return data_.get() + writePos_;
+    }
+
+    size_t used = size();
+    if (readPos_ > 0 && capacity_ - used >= minWritable) {
+        // 把未消费的数据移到缓冲开头，复用已有空间
+        std::memmove(data_.get(), data_.get() + readPos_, used);
+        readPos_ = 0;
+        writePos_ = used;
+    } else {
+        reallocate(std::max({capacity_ * 2, used + minWritable, kInitialCapacity}));
+    }
+    return data_.get() + writePos_;
+}
+
+void InputBuffer::reserve(size_t total) {
+    if (capacity_ - readPos_ >= total) {
+        return;
+    }
+    if (capacity_ >= total) {
+        std::memmove(data_.get(), data_.get() + readPos_, size());
+        writePos_ -= readPos_;
+        readPos_ = 0;
+        return;
+    }
+    reallocate(total);
+}
+
+void InputBuffer::consume(size_t count) {
+    readPos_ += std::min(count, size());
+    if (readPos_ == writePos_) {
+        readPos_ = 0;
+        writePos_ = 0;
+        // 大请求处理完后释放内存，常规大小的缓冲留给后续请求复用
+        if (capacity_ > kRetainCapacity) {
+            data_.reset();
+            capacity_ = 0;
+        }
+    }
+}
+
+void InputBuffer::reallocate(size_t capacity) {
+    size_t used = size();
+    std::unique_ptr<char[]> data(new char[capacity]);
+    if (used > 0) {
+        std::memcpy(data.get(), data_.get() + readPos_, used);
+    }
+    data_ = std::move(data);
+    capacity_ = capacity;
+    readPos_ = 0;
+    writePos_ = used;
+}
+
+} // namespace QualityManagement
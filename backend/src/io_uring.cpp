@@ -0,0 +1,185 @@
+#include "../include/io_uring.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace QualityManagement {
+
+namespace {
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+} // namespace
+
+IoUring::~IoUring() {
+    if (sqes_ != nullptr) {
+        munmap(sqes_, sqesSize_);
+    }
+    if (cqRing_ != nullptr && cqRing_ != sqRing_) {
+        munmap(cqRing_, cqRingSize_);
+    }
+    if (sqRing_ != nullptr) {
+        munmap(sqRing_, sqRingSize_);
+    }
+    if (ringFd_ >= 0) {
+        close(ringFd_);
+    }
+}
+
+bool IoUring::isSupported() {
+    io_uring_params params{};
+    int fd = ioUringSetup(2, &params);
+    if (fd < 0) {
+        // 内核过旧（ENOSYS）或被容器策略禁用（EPERM）
+        return false;
+    }
+
+    // 探测服务器用到的各个操作码
+    size_t probeSize = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    std::vector<unsigned char> storage(probeSize, 0);
+    auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    bool supported = ioUringRegister(fd, IORING_REGISTER_PROBE, probe, 256) == 0;
+    close(fd);
+    if (!supported) {
+        return false;
+    }
+
+    const unsigned required[] = {
+        IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_READ, IORING_OP_READ_FIXED,
+        IORING_OP_SENDMSG, IORING_OP_ASYNC_CANCEL
+    };
+    for (unsigned op : required) {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IoUring::init(unsigned entries) {
+    io_uring_params params{};
+    ringFd_ = ioUringSetup(entries, &params);
+    if (ringFd_ < 0) {
+        return false;
+    }
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    // 新内核中两个环共用一次映射
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+
+    sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   ringFd_, IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED) {
+        sqRing_ = nullptr;
+        return false;
+    }
+    if (singleMmap) {
+        cqRing_ = sqRing_;
+    } else {
+        cqRing_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ringFd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) {
+            cqRing_ = nullptr;
+            return false;
+        }
+    }
+
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(sqRing_);
+    sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqEntries_ = params.sq_entries;
+    sqeTail_ = *sqTail_;
+
+    char* cq = static_cast<char*>(cqRing_);
+    cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return true;
+}
+
+bool IoUring::registerBuffers(const iovec* buffers, unsigned count) {
+    return ioUringRegister(ringFd_, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+}
+
+io_uring_sqe* IoUring::getSqe() {
+    unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    if (sqeTail_ - head >= sqEntries_) {
+        // 提交队列已满，先交给内核腾出槽位
+        submitAndWait(0);
+        head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        if (sqeTail_ - head >= sqEntries_) {
+            return nullptr;
+        }
+    }
+
+    io_uring_sqe* sqe = &sqes_[sqeTail_ & sqMask_];
+    std::memset(sqe, 0, sizeof(*sqe));
+    ++sqeTail_;
+    return sqe;
+}
+
+void IoUring::flushSq() {
+    // SQE与索引数组一一对应，发布新的尾部之前先写好索引
+    unsigned tail = *sqTail_;
+    for (; tail != sqeTail_; ++tail) {
+        sqArray_[tail & sqMask_] = tail & sqMask_;
+    }
+    __atomic_store_n(sqTail_, sqeTail_, __ATOMIC_RELEASE);
+}
+
+int IoUring::submitAndWait(unsigned waitCount) {
+    flushSq();
+    unsigned flags = waitCount > 0 ? IORING_ENTER_GETEVENTS : 0;
+    while (true) {
+        // 以内核尚未消费的SQE数为准，被信号中断后重试不会遗漏
+        unsigned toSubmit = sqeTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        int result = ioUringEnter(ringFd_, toSubmit, waitCount, flags);
+        if (result >= 0 || errno != EINTR) {
+            return result;
+        }
+    }
+}
+
+bool IoUring::popCqe(io_uring_cqe& cqe) {
+    unsigned head = *cqHead_;
+    unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+        return false;
+    }
+    cqe = cqes_[head & cqMask_];
+    __atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+} // namespace QualityManagement
@@ -0,0 +1,223 @@
+#include "../include/job_manager.h"
+#include "../include/control_chart_feed.h"
+#include "../include/nlohmann/json.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace QualityManagement {
+
+using json = nlohmann::json;
+
+namespace {
+
+const auto kProgressInterval = std::chrono::milliseconds(250);  // 进度事件的最小间隔
+const auto kSweepInterval = std::chrono::seconds(1);            // 过期检查的最小间隔
+
+const char* statusName(Job::Status status) {
+    switch (status) {
+    case Job::Status::Queued: return "queued";
+    case Job::Status::Running: return "running";
+    case Job::Status::Done: return "done";
+    case Job::Status::Failed: return "failed";
+    case Job::Status::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+int64_t millisecondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+} // namespace
+
+Job::Job(std::string id, std::string path, BodyFormat format)
+    : id_(std::move(id)), path_(std::move(path)), format_(format), createdAt_(std::chrono::steady_clock::now()) {
+}
+
+void Job::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    status_ = Status::Running;
+    startedAt_ = std::chrono::steady_clock::now();
+    notifyLocked(false);
+}
+
+void Job::addProgress(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resultBytes_ += bytes;
+    if (!subscribers_.empty() && std::chrono::steady_clock::now() - lastNotify_ >= kProgressInterval) {
+        notifyLocked(false);
+    }
+}
+
+void Job::finish(std::string result, bool ok) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    status_ = ok ? Status::Done : Status::Failed;
+    resultBytes_ = result.size();
+    finishedAt_ = std::chrono::steady_clock::now();
+    result_ = std::make_shared<const std::string>(std::move(result));
+    notifyLocked(true);
+    subscribers_.clear();
+}
+
+bool Job::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (status_ != Status::Queued) {
+        return false;
+    }
+    status_ = Status::Cancelled;
+    finishedAt_ = std::chrono::steady_clock::now();
+    startedAt_ = finishedAt_;
+    result_ = std::make_shared<const std::string>(
+        json({{"success", false}, {"error", "服务器停止，任务未执行"}}).dump());
+    resultBytes_ = result_->size();
+    notifyLocked(true);
+    subscribers_.clear();
+    return true;
+}
+
+bool Job::finished() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return result_ != nullptr;
+}
+
+std::chrono::steady_clock::time_point Job::finishedAt() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return finishedAt_;
+}
+
+std::shared_ptr<const std::string> Job::result() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return result_;
+}
+
+std::string Job::statusJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statusJsonLocked();
+}
+
+void Job::subscribe(Subscriber subscriber) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool last = result_ != nullptr;
+    if (subscriber(ControlChartFeed::encodeEvent("status", statusJsonLocked()), last) && !last) {
+        subscribers_.push_back(std::move(subscriber));
+    }
+}
+
+std::string Job::statusJsonLocked() const {
+    auto now = std::chrono::steady_clock::now();
+    json status = {
+        {"success", true},
+        {"jobId", id_},
+        {"endpoint", path_},
+        {"status", statusName(status_)},
+        {"resultBytes", resultBytes_},
+        {"elapsedMs", millisecondsBetween(createdAt_, result_ ? finishedAt_ : now)}
+    };
+    if (status_ != Status::Queued) {
+        status["queuedMs"] = millisecondsBetween(createdAt_, startedAt_);
+    }
+    return status.dump();
+}
+
+void Job::notifyLocked(bool last) {
+    lastNotify_ = std::chrono::steady_clock::now();
+    if (subscribers_.empty()) {
+        return;
+    }
+    std::string event = ControlChartFeed::encodeEvent("status", statusJsonLocked());
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+                                      [&](const Subscriber& subscriber) { return !subscriber(event, last); }),
+                       subscribers_.end());
+}
+
+JobManager::JobManager(uint64_t ttlMs, size_t maxJobs)
+    : ttlMs_(ttlMs), maxJobs_(std::max<size_t>(1, maxJobs)), random_(std::random_device{}()) {
+}
+
+std::shared_ptr<Job> JobManager::create(const std::string& path, BodyFormat format) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    expireLocked(now, false);
+    if (jobs_.size() >= maxJobs_) {
+        expireLocked(now, true);
+    }
+    if (jobs_.size() >= maxJobs_) {
+        // 仍然已满时提前删除最早结束的任务，全部未结束时拒绝
+        auto oldest = jobs_.end();
+        for (auto it = jobs_.begin(); it != jobs_.end(); ++it) {
+            if (it->second->finished() &&
+                (oldest == jobs_.end() || it->second->finishedAt() < oldest->second->finishedAt())) {
+                oldest = it;
+            }
+        }
+        if (oldest == jobs_.end()) {
+            return nullptr;
+        }
+        jobs_.erase(oldest);
+    }
+
+    // 64位随机任务号，其他客户端无法猜到别人的结果
+    std::string id;
+    do {
+        char text[17];
+        std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(random_()));
+        id = text;
+    } while (jobs_.count(id) != 0);
+
+    auto job = std::make_shared<Job>(id, path, format);
+    jobs_.emplace(id, job);
+    return job;
+}
+
+std::shared_ptr<Job> JobManager::find(std::string_view id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    expireLocked(now, false);
+    auto it = jobs_.find(std::string(id));
+    if (it == jobs_.end()) {
+        return nullptr;
+    }
+    if (it->second->finished() && now - it->second->finishedAt() >= std::chrono::milliseconds(ttlMs_)) {
+        jobs_.erase(it);
+        return nullptr;
+    }
+    return it->second;
+}
+
+void JobManager::remove(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.erase(id);
+}
+
+size_t JobManager::cancelQueued() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (auto& entry : jobs_) {
+        if (entry.second->cancel()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+size_t JobManager::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size();
+}
+
+void JobManager::expireLocked(std::chrono::steady_clock::time_point now, bool force) {
+    if (!force && now - lastSweep_ < kSweepInterval) {
+        return;
+    }
+    lastSweep_ = now;
+    auto ttl = std::chrono::milliseconds(ttlMs_);
+    for (auto it = jobs_.begin(); it != jobs_.end();) {
+        if (it->second->finished() && now - it->second->finishedAt() >= ttl) {
+            it = jobs_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace QualityManagement
@@ -0,0 +1,478 @@
+#include "../include/json_stream_writer.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace QualityManagement {
+
+namespace {
+
+const size_t kFlushThreshold = 64 * 1024;   // 缓冲达到该大小后作为一个分段写出
+
+// 按nlohmann::json的规则排版最短往返的十进制数字：十进制指数在(-4, 15]内用定点形式，
+// 整数值补".0"，其余用科学计数法且指数至少两位（如1e-05、1.5e+20）。
+// digits为有效数字，n为小数点位置（数值等于0.digits × 10^n）
+char* layoutNumber(char* out, const char* digits, int k, int n) {
+    if (k <= n && n <= 15) {
+        out = std::copy(digits, digits + k, out);
+        out = std::fill_n(out, n - k, '0');
+        *out++ = '.';
+        *out++ = '0';
+        return out;
+    }
+    if (0 < n && n <= 15) {
+        out = std::copy(digits, digits + n, out);
+        *out++ = '.';
+        return std::copy(digits + n, digits + k, out);
+    }
+    if (-4 < n && n <= 0) {
+        *out++ = '0';
+        *out++ = '.';
+        out = std::fill_n(out, -n, '0');
+        return std::copy(digits, digits + k, out);
+    }
+
+    *out++ = digits[0];
+    if (k > 1) {
+        *out++ = '.';
+        out = std::copy(digits + 1, digits + k, out);
+    }
+    int exponent = n - 1;
+    *out++ = 'e';
+    *out++ = exponent < 0 ? '-' : '+';
+    exponent = std::abs(exponent);
+    if (exponent < 10) {
+        *out++ = '0';
+    }
+    return std::to_chars(out, out + 4, exponent).ptr;
+}
+
+} // namespace
+
+JsonStreamWriter::JsonStreamWriter(ResponseSink& sink, BodyFormat format) : sink_(sink), format_(format) {
+    buffer_.reserve(kFlushThreshold + 1024);
+}
+
+JsonStreamWriter& JsonStreamWriter::raw(std::string_view text) {
+    if (format_ != BodyFormat::Json) {
+        throw std::logic_error("raw()只能用于JSON输出");
+    }
+    buffer_.append(text.data(), text.size());
+    maybeFlush();
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::value(const nlohmann::json& value) {
+    beginValue();
+    switch (format_) {
+    case BodyFormat::Json: buffer_ += value.dump(); break;
+    case BodyFormat::Cbor: nlohmann::json::to_cbor(value, buffer_); break;
+    case BodyFormat::MessagePack: nlohmann::json::to_msgpack(value, buffer_); break;
+    }
+    maybeFlush();
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::beginObject(size_t count) {
+    beginValue();
+    Frame frame{false, count, 0, 0};
+    switch (format_) {
+    case BodyFormat::Json:
+        buffer_ += '{';
+        break;
+    case BodyFormat::Cbor:
+        if (count == kUnknownCount) {
+            buffer_ += '\xbf';   // 不定长映射，以0xff结束
+        } else {
+            appendHead(5, count);
+        }
+        break;
+    case BodyFormat::MessagePack:
+        if (count == kUnknownCount) {
+            // 先占用最长的map32映射头，结束时按实际个数改写并收缩为最短形式
+            frame.headerPos = buffer_.size();
+            buffer_.append(5, '\0');
+            ++pinned_;
+        } else if (count <= 15) {
+            buffer_ += static_cast<char>(0x80 | count);
+        } else if (count <= 0xffff) {
+            buffer_ += '\xde';
+            appendBigEndian(count, 2);
+        } else {
+            buffer_ += '\xdf';
+            appendBigEndian(count, 4);
+        }
+        break;
+    }
+    frames_.push_back(frame);
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::endObject() {
+    Frame frame = frames_.back();
+    closeFrame(false);
+    switch (format_) {
+    case BodyFormat::Json:
+        buffer_ += '}';
+        break;
+    case BodyFormat::Cbor:
+        if (frame.expected == kUnknownCount) {
+            buffer_ += '\xff';
+        }
+        break;
+    case BodyFormat::MessagePack:
+        if (frame.expected == kUnknownCount) {
+            // 映射头之后的内容都还在缓冲中，收缩映射头只移动这个对象本身
+            char* header = &buffer_[frame.headerPos];
+            if (frame.count <= 15) {
+                header[0] = static_cast<char>(0x80 | frame.count);
+                buffer_.erase(frame.headerPos + 1, 4);
+            } else if (frame.count <= 0xffff) {
+                header[0] = '\xde';
+                header[1] = static_cast<char>(frame.count >> 8);
+                header[2] = static_cast<char>(frame.count);
+                buffer_.erase(frame.headerPos + 3, 2);
+            } else {
+                header[0] = '\xdf';
+                for (int i = 0; i < 4; ++i) {
+                    header[1 + i] = static_cast<char>(frame.count >> (24 - 8 * i));
+                }
+            }
+            --pinned_;
+        }
+        break;
+    }
+    maybeFlush();
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::key(std::string_view name) {
+    if (!frames_.empty()) {
+        Frame& frame = frames_.back();
+        if (format_ == BodyFormat::Json && frame.count > 0) {
+            buffer_ += ',';
+        }
+        ++frame.count;
+    }
+    string(name);
+    if (format_ == BodyFormat::Json) {
+        buffer_ += ':';
+    }
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::beginArray(size_t count) {
+    beginValue();
+    switch (format_) {
+    case BodyFormat::Json:
+        buffer_ += '[';
+        break;
+    case BodyFormat::Cbor:
+        appendHead(4, count);
+        break;
+    case BodyFormat::MessagePack:
+        if (count <= 15) {
+            buffer_ += static_cast<char>(0x90 | count);
+        } else if (count <= 0xffff) {
+            buffer_ += '\xdc';
+            appendBigEndian(count, 2);
+        } else {
+            buffer_ += '\xdd';
+            appendBigEndian(count, 4);
+        }
+        break;
+    }
+    frames_.push_back({true, count, 0, 0});
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::endArray() {
+    closeFrame(true);
+    if (format_ == BodyFormat::Json) {
+        buffer_ += ']';
+    }
+    maybeFlush();
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::number(double value) {
+    beginValue();
+    if (format_ == BodyFormat::Json) {
+        appendNumber(value);
+    } else {
+        appendBinaryNumber(value);
+    }
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::number(int64_t value) {
+    beginValue();
+    appendInteger(value);
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::boolean(bool value) {
+    beginValue();
+    switch (format_) {
+    case BodyFormat::Json: buffer_ += value ? "true" : "false"; break;
+    case BodyFormat::Cbor: buffer_ += value ? '\xf5' : '\xf4'; break;
+    case BodyFormat::MessagePack: buffer_ += value ? '\xc3' : '\xc2'; break;
+    }
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::string(std::string_view value) {
+    beginValue();
+    if (format_ == BodyFormat::Cbor) {
+        appendHead(3, value.size());
+        buffer_.append(value.data(), value.size());
+        return *this;
+    }
+    if (format_ == BodyFormat::MessagePack) {
+        if (value.size() <= 31) {
+            buffer_ += static_cast<char>(0xa0 | value.size());
+        } else if (value.size() <= 0xff) {
+            buffer_ += '\xd9';
+            appendBigEndian(value.size(), 1);
+        } else if (value.size() <= 0xffff) {
+            buffer_ += '\xda';
+            appendBigEndian(value.size(), 2);
+        } else {
+            buffer_ += '\xdb';
+            appendBigEndian(value.size(), 4);
+        }
+        buffer_.append(value.data(), value.size());
+        return *this;
+    }
+
+    static const char kHex[] = "0123456789abcdef";
+    buffer_ += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': buffer_ += "\\\""; break;
+            case '\\': buffer_ += "\\\\"; break;
+            case '\b': buffer_ += "\\b"; break;
+            case '\f': buffer_ += "\\f"; break;
+            case '\n': buffer_ += "\\n"; break;
+            case '\r': buffer_ += "\\r"; break;
+            case '\t': buffer_ += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    buffer_ += "\\u00";
+                    buffer_ += kHex[(c >> 4) & 0x0f];
+                    buffer_ += kHex[c & 0x0f];
+                } else {
+                    buffer_ += c;
+                }
+        }
+    }
+    buffer_ += '"';
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::numberArray(SampleSpan values) {
+    beginArray(values.size());
+    Frame& frame = frames_.back();
+    bool json = format_ == BodyFormat::Json;
+    for (size_t i = 0; i < values.size() && ok_; ++i) {
+        if (json) {
+            if (i > 0) {
+                buffer_ += ',';
+            }
+            appendNumber(values[i]);
+        } else {
+            appendBinaryNumber(values[i]);
+        }
+        maybeFlush();
+    }
+    // 元素直接写入缓冲，没有经过beginValue计数
+    frame.count = values.size();
+    return endArray();
+}
+
+JsonStreamWriter& JsonStreamWriter::indexArray(const std::vector<size_t>& values) {
+    beginArray(values.size());
+    for (size_t i = 0; i < values.size() && ok_; ++i) {
+        number(static_cast<int64_t>(values[i]));
+        maybeFlush();
+    }
+    return endArray();
+}
+
+void JsonStreamWriter::beginValue() {
+    if (frames_.empty() || !frames_.back().array) {
+        return;
+    }
+    Frame& frame = frames_.back();
+    if (format_ == BodyFormat::Json && frame.count > 0) {
+        buffer_ += ',';
+    }
+    ++frame.count;
+}
+
+void JsonStreamWriter::closeFrame(bool array) {
+    if (frames_.empty() || frames_.back().array != array) {
+        throw std::logic_error("对象与数组的开始和结束不匹配");
+    }
+    const Frame& frame = frames_.back();
+    // 二进制格式的头部已写出个数，个数不符时输出无法解码
+    if (frame.expected != kUnknownCount && frame.count != frame.expected && ok_) {
+        throw std::logic_error("写出的成员个数与声明的个数不一致");
+    }
+    frames_.pop_back();
+}
+
+void JsonStreamWriter::appendInteger(int64_t value) {
+    if (format_ == BodyFormat::Json) {
+        char text[24];
+        char* end = std::to_chars(text, text + sizeof(text), value).ptr;
+        buffer_.append(text, end);
+    } else if (format_ == BodyFormat::Cbor) {
+        // 负数n编码为主类型1的-1-n
+        if (value >= 0) {
+            appendHead(0, static_cast<uint64_t>(value));
+        } else {
+            appendHead(1, static_cast<uint64_t>(-(value + 1)));
+        }
+    } else if (value >= 0) {
+        if (value < 128) {
+            buffer_ += static_cast<char>(value);
+        } else if (value <= 0xff) {
+            buffer_ += '\xcc';
+            appendBigEndian(static_cast<uint64_t>(value), 1);
+        } else if (value <= 0xffff) {
+            buffer_ += '\xcd';
+            appendBigEndian(static_cast<uint64_t>(value), 2);
+        } else if (value <= 0xffffffff) {
+            buffer_ += '\xce';
+            appendBigEndian(static_cast<uint64_t>(value), 4);
+        } else {
+            buffer_ += '\xcf';
+            appendBigEndian(static_cast<uint64_t>(value), 8);
+        }
+    } else if (value >= -32) {
+        buffer_ += static_cast<char>(value);
+    } else if (value >= INT8_MIN) {
+        buffer_ += '\xd0';
+        appendBigEndian(static_cast<uint64_t>(value), 1);
+    } else if (value >= INT16_MIN) {
+        buffer_ += '\xd1';
+        appendBigEndian(static_cast<uint64_t>(value), 2);
+    } else if (value >= INT32_MIN) {
+        buffer_ += '\xd2';
+        appendBigEndian(static_cast<uint64_t>(value), 4);
+    } else {
+        buffer_ += '\xd3';
+        appendBigEndian(static_cast<uint64_t>(value), 8);
+    }
+}
+
+void JsonStreamWriter::appendBinaryNumber(double value) {
+    bool cbor = format_ == BodyFormat::Cbor;
+    if (!std::isfinite(value)) {
+        // 与JSON输出一致，非有限值写为null
+        buffer_ += cbor ? '\xf6' : '\xc0';
+        return;
+    }
+    // 能以单精度无损表示时只占5字节，规则与nlohmann的to_cbor/to_msgpack相同
+    if (value >= std::numeric_limits<float>::lowest() && value <= std::numeric_limits<float>::max() &&
+        static_cast<double>(static_cast<float>(value)) == value) {
+        float single = static_cast<float>(value);
+        uint32_t bits;
+        std::memcpy(&bits, &single, sizeof(bits));
+        buffer_ += cbor ? '\xfa' : '\xca';
+        appendBigEndian(bits, 4);
+        return;
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    buffer_ += cbor ? '\xfb' : '\xcb';
+    appendBigEndian(bits, 8);
+}
+
+void JsonStreamWriter::appendHead(uint8_t major, uint64_t value) {
+    // CBOR头部：主类型占高3位，小于24的值直接放在低5位，否则跟随1、2、4或8字节
+    char type = static_cast<char>(major << 5);
+    if (value < 24) {
+        buffer_ += static_cast<char>(type | value);
+    } else if (value <= 0xff) {
+        buffer_ += static_cast<char>(type | 24);
+        appendBigEndian(value, 1);
+    } else if (value <= 0xffff) {
+        buffer_ += static_cast<char>(type | 25);
+        appendBigEndian(value, 2);
+    } else if (value <= 0xffffffff) {
+        buffer_ += static_cast<char>(type | 26);
+        appendBigEndian(value, 4);
+    } else {
+        buffer_ += static_cast<char>(type | 27);
+        appendBigEndian(value, 8);
+    }
+}
+
+void JsonStreamWriter::appendBigEndian(uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        buffer_ += static_cast<char>(value >> (8 * i));
+    }
+}
+
+void JsonStreamWriter::appendNumber(double value) {
+    if (!std::isfinite(value)) {
+        buffer_ += "null";
+        return;
+    }
+
+    // to_chars的科学计数法给出最短往返的有效数字和十进制指数，再按nlohmann的规则排版
+    char scientific[32];
+    char* end = std::to_chars(scientific, scientific + sizeof(scientific), value,
+                              std::chars_format::scientific).ptr;
+    const char* p = scientific;
+    char text[48];
+    char* out = text;
+    if (*p == '-') {
+        *out++ = '-';
+        ++p;
+    }
+    char digits[20];
+    int k = 0;
+    for (; p < end && *p != 'e'; ++p) {
+        if (*p != '.') {
+            digits[k++] = *p;
+        }
+    }
+    int exponent = 0;
+    ++p;
+    if (p < end && *p == '+') {
+        ++p;
+    }
+    std::from_chars(p, end, exponent);
+    out = layoutNumber(out, digits, k, exponent + 1);
+    buffer_.append(text, out);
+}
+
+bool JsonStreamWriter::flush() {
+    if (pinned_ > 0) {
+        // 未知个数的MessagePack对象尚未结束，映射头还要改写
+        return ok_;
+    }
+    if (ok_ && !buffer_.empty()) {
+        std::string chunk;
+        chunk.reserve(kFlushThreshold + 1024);
+        chunk.swap(buffer_);
+        ok_ = sink_.write(std::move(chunk));
+    }
+    buffer_.clear();
+    return ok_;
+}
+
+void JsonStreamWriter::maybeFlush() {
+    if (pinned_ == 0 && buffer_.size() >= kFlushThreshold) {
+        flush();
+    }
+}
+
+} // namespace QualityManagement
@@ -0,0 +1,80 @@
+#include "../include/output_queue.h"
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace QualityManagement {
+
+namespace {
+
+const size_t kMaxIovecs = 64;   // 单次writev最多携带的数据块数
+
+} // namespace
+
+void OutputQueue::append(std::string chunk) {
+    if (chunk.empty()) {
+        return;
+    }
+    pendingBytes_ += chunk.size();
+    chunks_.push_back(Chunk{std::move(chunk), nullptr});
+}
+
+void OutputQueue::append(std::shared_ptr<const std::string> chunk) {
+    if (!chunk || chunk->empty()) {
+        return;
+    }
+    pendingBytes_ += chunk->size();
+    chunks_.push_back(Chunk{std::string(), std::move(chunk)});
+}
+
+OutputQueue::WriteResult OutputQueue::writeTo(int fd) {
+    iovec iov[kMaxIovecs];
+
+    while (!chunks_.empty()) {
+        msghdr message{};
+        message.msg_iov = iov;
+        message.msg_iovlen = prepareIovecs(iov, kMaxIovecs);
+        ssize_t sent = sendmsg(fd, &message, MSG_NOSIGNAL);
+        if (sent > 0) {
+            advance(static_cast<size_t>(sent));
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return WriteResult::WouldBlock;
+        }
+        return WriteResult::Error;
+    }
+    return WriteResult::Drained;
+}
+
+size_t OutputQueue::prepareIovecs(iovec* iov, size_t maxCount) const {
+    // 把队列前部的数据块组装成iovec，首块从已发送位置开始
+    size_t count = 0;
+    for (auto it = chunks_.begin(); it != chunks_.end() && count < maxCount; ++it, ++count) {
+        std::string_view data = it->view();
+        size_t offset = count == 0 ? headOffset_ : 0;
+        iov[count].iov_base = const_cast<char*>(data.data() + offset);
+        iov[count].iov_len = data.size() - offset;
+    }
+    return count;
+}
+
+void OutputQueue::advance(size_t count) {
+    pendingBytes_ -= count;
+    while (count > 0) {
+        size_t remaining = chunks_.front().view().size() - headOffset_;
+        if (count < remaining) {
+            headOffset_ += count;
+            return;
+        }
+        // 整块发送完毕后立即释放，大响应不会在内存中停留到连接结束
+        count -= remaining;
+        chunks_.pop_front();
+        headOffset_ = 0;
+    }
+}
+
+} // namespace QualityManagement
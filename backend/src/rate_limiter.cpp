@@ -0,0 +1,182 @@
+#include "../include/rate_limiter.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace QualityManagement {
+
+namespace {
+
+const int kProbes = 8;                       // 开放寻址时最多探测的位置数
+const uint64_t kMaxCapacity = 4000000000ull; // 令牌数以千分之一为单位存在32位中
+const int kMaxRetryAfter = 60;               // Retry-After的上限（秒）
+
+// 桶正在被回收给另一个客户端时的状态；令牌数不超过kMaxCapacity，不会与正常状态混淆
+const uint64_t kRecycling = ~0ull;
+
+// 各接口消耗的令牌数，与计算量大致成比例
+struct EndpointCost {
+    std::string_view path;
+    uint32_t cost;
+};
+
+const EndpointCost kCosts[] = {
+    {"/all-analysis", 10},
+    {"/import-data", 5},
+    {"/append-data", 5},
+    {"/process-assessment", 4},
+    {"/normality-test", 4},
+    {"/descriptive-stats", 3},
+    {"/capability-indices", 3},
+    {"/control-chart", 2},
+    {"/mean-test", 2},
+    {"/generate-data", 2},
+};
+
+uint64_t steadyMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 把客户端标识打散到整张表上
+uint64_t mix(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return key;
+}
+
+uint64_t pack(uint64_t tokens, uint32_t now) {
+    return (tokens << 32) | now;
+}
+
+} // namespace
+
+RateLimiter::RateLimiter(uint32_t ratePerSecond, uint32_t burst, size_t slotCount)
+    : ratePerSecond_(ratePerSecond),
+      capacity_(std::min<uint64_t>(std::max<uint32_t>(1, burst) * 1000ull, kMaxCapacity)),
+      mask_([slotCount] {
+          size_t size = 1;
+          while (size < slotCount) {
+              size <<= 1;
+          }
+          return size - 1;
+      }()),
+      startMs_(steadyMs()),
+      slots_(new Slot[mask_ + 1]) {
+}
+
+uint32_t RateLimiter::endpointCost(std::string_view path) {
+    // /jobs/<接口>与同步调用该接口消耗相同的令牌
+    constexpr std::string_view jobsPrefix = "/jobs/";
+    if (path.substr(0, jobsPrefix.size()) == jobsPrefix) {
+        path.remove_prefix(jobsPrefix.size() - 1);
+    }
+    for (const auto& entry : kCosts) {
+        if (entry.path == path) {
+            return entry.cost;
+        }
+    }
+    return 1;
+}
+
+uint32_t RateLimiter::nowMs() const {
+    // 只用于计算间隔，32位回绕后差值仍然正确
+    return static_cast<uint32_t>(steadyMs() - startMs_);
+}
+
+uint64_t RateLimiter::refill(uint64_t state, uint32_t now) const {
+    // 其他线程可能以稍晚的时间更新过状态，此时不补充
+    uint64_t tokens = state >> 32;
+    int32_t elapsed = static_cast<int32_t>(now - static_cast<uint32_t>(state));
+    if (elapsed <= 0) {
+        return tokens;
+    }
+    return std::min(capacity_, tokens + static_cast<uint64_t>(elapsed) * ratePerSecond_);
+}
+
+uint64_t RateLimiter::loadState(const Slot& slot) {
+    // 回收只在占位值和新状态之间写两次，很快结束
+    uint64_t state;
+    while ((state = slot.state.load(std::memory_order_acquire)) == kRecycling) {
+        std::this_thread::yield();
+    }
+    return state;
+}
+
+bool RateLimiter::consume(Slot& slot, uint64_t key, uint64_t need, uint32_t now, int& retryAfter) {
+    uint64_t state = loadState(slot);
+    while (true) {
+        // 先读状态再核对客户端：回收会改变状态，之后的比较交换成功说明扣除的仍是这个客户端的桶
+        if (slot.key.load(std::memory_order_acquire) != key) {
+            return false;
+        }
+        uint64_t tokens = refill(state, now);
+        if (tokens < need) {
+            throttled_.fetch_add(1, std::memory_order_relaxed);
+            uint64_t waitMs = (need - tokens + ratePerSecond_ - 1) / ratePerSecond_;
+            retryAfter = static_cast<int>(std::min<uint64_t>(waitMs / 1000 + 1, kMaxRetryAfter));
+            return true;
+        }
+        uint32_t last = static_cast<uint32_t>(state);
+        uint32_t stamp = static_cast<int32_t>(now - last) > 0 ? now : last;
+        if (slot.state.compare_exchange_weak(state, pack(tokens - need, stamp), std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+            retryAfter = 0;
+            return true;
+        }
+        if (state == kRecycling) {
+            state = loadState(slot);
+        }
+    }
+}
+
+bool RateLimiter::claim(Slot& slot, uint64_t key, uint64_t need, uint32_t now) {
+    // 新客户端占用空位，或回收一个已补满的桶：补满的桶与新建的桶没有区别。
+    // 回收要求补充时间已经过去，新状态的时间戳因此严格大于旧状态，同一位置的状态不会重复出现
+    uint64_t state = loadState(slot);
+    uint64_t current = slot.key.load(std::memory_order_acquire);
+    if (current != 0 && refill(state, now) < capacity_) {
+        return false;
+    }
+    if (!slot.state.compare_exchange_strong(state, kRecycling, std::memory_order_acq_rel)) {
+        return false;
+    }
+    // 占用时直接扣除本次的令牌，新状态不会与任何已补满的旧状态相同
+    slot.key.store(key, std::memory_order_relaxed);
+    slot.state.store(pack(capacity_ - need, now), std::memory_order_release);
+    return true;
+}
+
+int RateLimiter::tryConsume(uint64_t clientKey, uint32_t cost) {
+    if (!enabled()) {
+        return 0;
+    }
+
+    uint32_t now = nowMs();
+    uint64_t key = clientKey == 0 ? 1 : clientKey;
+    // 单次请求的代价不超过桶容量，否则永远无法放行；至少扣除一点，已占用的桶不会保持满的状态
+    uint64_t need = std::clamp<uint64_t>(cost * 1000ull, 1, capacity_);
+    size_t start = static_cast<size_t>(mix(key));
+    int retryAfter = 0;
+    for (int i = 0; i < kProbes; ++i) {
+        Slot& slot = slots_[(start + i) & mask_];
+        if (slot.key.load(std::memory_order_acquire) == key && consume(slot, key, need, now, retryAfter)) {
+            return retryAfter;
+        }
+    }
+
+    for (int i = 0; i < kProbes; ++i) {
+        Slot& slot = slots_[(start + i) & mask_];
+        if (claim(slot, key, need, now)) {
+            return 0;
+        }
+        // 同一客户端的另一个请求刚刚占用了这个位置
+        if (slot.key.load(std::memory_order_acquire) == key && consume(slot, key, need, now, retryAfter)) {
+            return retryAfter;
+        }
+    }
+    return 0;
+}
+
+} // namespace QualityManagement
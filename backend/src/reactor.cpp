@@ -0,0 +1,1015 @@
+#include "../include/reactor.h"
+#include "../include/nlohmann/json.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+namespace QualityManagement {
+
+using json = nlohmann::json;
+
+namespace {
+
+const uint64_t kTimerTickMs = 100;   // 连接超时的检查粒度
+const std::string_view kControlChartStreamPath = "/control-chart/stream";
+const std::string_view kJobsPrefix = "/jobs/";
+const size_t kMaxCoalescedBody = 4096;  // 参与合并的请求体上限，大请求体（如导入数据）不值得规范化比较
+const size_t kMaxEstimatedBody = 4096;  // 估算代价时在事件循环中解析的请求体上限
+
+// 异步任务的结果输出端：收集流式接口的全部输出，并把已生成的字节数报告为进度
+class JobSink : public ResponseSink {
+public:
+    explicit JobSink(Job& job) : job_(job) {}
+
+    bool write(std::string chunk) override {
+        job_.addProgress(chunk.size());
+        data_ += chunk;
+        return true;
+    }
+
+    std::string take() { return std::move(data_); }
+
+private:
+    Job& job_;
+    std::string data_;
+};
+
+// /generate-data的计算量由请求参数决定：请求体很小，在事件循环中解析一次用于估算代价；
+// 更大的请求体不解析，要求的规模视为无限大，只在没有其他已接纳请求时放行
+uint64_t requestedSamples(const std::string& path, const HttpRequest& request) {
+    if (path != "/generate-data") {
+        return 0;
+    }
+    if (request.body.size() > kMaxEstimatedBody) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    try {
+        return ApiHandler::generatedSampleCount(decodeBody(request.body, requestBodyFormat(request.contentType)));
+    } catch (const json::exception&) {
+        // 请求体格式错误，处理时直接报错
+        return 0;
+    }
+}
+
+HttpResponse jobNotFound(bool keepAlive) {
+    return makeJsonResponse(json({
+        {"success", false},
+        {"error", "任务不存在或已过期"}
+    }).dump(), keepAlive, "404 Not Found");
+}
+
+// 健康检查和就绪探针的几种固定状态
+enum class ProbeState {
+    Healthy,
+    Ready,
+    ReadyNoData,
+    Saturated,
+    Draining,
+    Count
+};
+
+// 探针响应在首次使用时生成，之后每次只复制预先渲染好的响应头和响应体
+HttpResponse probeResponse(ProbeState state, bool keepAlive) {
+    static const auto responses = [] {
+        const size_t count = static_cast<size_t>(ProbeState::Count);
+        std::vector<HttpResponse> result;
+        result.reserve(count * 2);
+        for (bool alive : {false, true}) {
+            result.push_back(makeJsonResponse("{\"status\":\"ok\"}", alive));
+            result.push_back(makeJsonResponse("{\"ready\":true,\"dataLoaded\":true}", alive));
+            result.push_back(makeJsonResponse("{\"ready\":true,\"dataLoaded\":false}", alive));
+            result.push_back(makeJsonResponse("{\"ready\":false,\"reason\":\"计算任务队列已满\"}", alive,
+                                              "503 Service Unavailable"));
+            result.push_back(makeJsonResponse("{\"ready\":false,\"reason\":\"服务器正在关闭\"}", alive,
+                                              "503 Service Unavailable"));
+        }
+        return result;
+    }();
+    return responses[(keepAlive ? static_cast<size_t>(ProbeState::Count) : 0) + static_cast<size_t>(state)];
+}
+
+// IPv4地址直接作为客户端标识（加上标记位，与0区分）
+uint64_t ipv4Key(const in_addr& address) {
+    return (uint64_t(4) << 56) | ntohl(address.s_addr);
+}
+
+// 其他地址取FNV-1a散列
+uint64_t hashKey(const void* data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash | 1;
+}
+
+// 由对端地址得到客户端标识；回环地址和Unix域套接字上的对端视为本机反向代理
+uint64_t addressKey(const sockaddr* address, socklen_t length, bool& trusted) {
+    trusted = false;
+    if (address != nullptr && address->sa_family == AF_INET && length >= sizeof(sockaddr_in)) {
+        const in_addr& ip = reinterpret_cast<const sockaddr_in*>(address)->sin_addr;
+        trusted = (ntohl(ip.s_addr) >> 24) == 127;
+        return ipv4Key(ip);
+    }
+    if (address != nullptr && address->sa_family == AF_INET6 && length >= sizeof(sockaddr_in6)) {
+        const in6_addr& ip = reinterpret_cast<const sockaddr_in6*>(address)->sin6_addr;
+        trusted = IN6_IS_ADDR_LOOPBACK(&ip);
+        return hashKey(&ip, sizeof(ip));
+    }
+    trusted = true;
+    return 0;
+}
+
+// 反向代理以文本传来的客户端地址
+uint64_t textAddressKey(std::string_view text) {
+    char buffer[INET6_ADDRSTRLEN];
+    if (text.size() < sizeof(buffer)) {
+        std::memcpy(buffer, text.data(), text.size());
+        buffer[text.size()] = '\0';
+        in_addr ip;
+        if (inet_pton(AF_INET, buffer, &ip) == 1) {
+            return ipv4Key(ip);
+        }
+    }
+    return hashKey(text.data(), text.size());
+}
+
+} // namespace
+
+Reactor::Reactor(ApiHandler& apiHandler, ThreadPool& computePool, AdmissionController& admission,
+                 RateLimiter& rateLimiter, JobManager& jobs, RequestCoalescer& coalescer,
+                 std::vector<int> listenFds, const ServerOptions& options)
+    : apiHandler_(apiHandler), computePool_(computePool), admission_(admission), rateLimiter_(rateLimiter),
+      jobs_(jobs), coalescer_(coalescer), listenFds_(std::move(listenFds)), options_(options),
+      timers_(kTimerTickMs) {
+}
+
+Reactor::~Reactor() {
+    for (auto& entry : connections_) {
+        close(entry.first);
+    }
+}
+
+void Reactor::stop() {
+    running_.store(false, std::memory_order_release);
+    wakeup();
+}
+
+bool Reactor::isListener(int fd) const {
+    return std::find(listenFds_.begin(), listenFds_.end(), fd) != listenFds_.end();
+}
+
+void Reactor::beginDrain() {
+    draining_.store(true, std::memory_order_release);
+    wakeup();
+}
+
+bool Reactor::drainComplete() {
+    if (!drainStarted_) {
+        drainStarted_ = true;
+        stopAccepting();
+
+        // 没有进行中请求、也没有未发完响应的连接以及事件流直接关闭；其余连接在当前请求应答后关闭
+        std::vector<int> idle;
+        for (auto& entry : connections_) {
+            const Connection& conn = *entry.second;
+            if (conn.eventStream || (!conn.busy && !conn.spool && conn.output.empty() && conn.input->empty())) {
+                idle.push_back(entry.first);
+            }
+        }
+        for (int fd : idle) {
+            closeConnection(fd);
+        }
+    }
+    return connections_.empty();
+}
+
+void Reactor::postCompletion(int fd, uint64_t connectionId, HttpResponse response, bool last) {
+    bool needWakeup;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex_);
+        needWakeup = completions_.empty();
+        completions_.push_back({fd, connectionId, std::move(response), last});
+    }
+    // 队列原本非空时事件循环已被唤醒过，无需重复写eventfd
+    if (needWakeup) {
+        wakeup();
+    }
+}
+
+void Reactor::handleCompletions() {
+    std::vector<Completion> completions;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex_);
+        completions.swap(completions_);
+    }
+
+    for (auto& completion : completions) {
+        auto it = connections_.find(completion.fd);
+        if (it == connections_.end() || it->second->id != completion.connectionId) {
+            // 连接在计算期间已关闭，丢弃结果
+            continue;
+        }
+
+        Connection& conn = *it->second;
+        if (conn.eventStream && conn.output.pendingBytes() > options_.streamBacklog) {
+            // 事件流的客户端读取太慢，断开让它重连后从新的快照开始
+            conn.eventStreamOpen->store(false, std::memory_order_release);
+            closeConnection(conn.fd);
+            continue;
+        }
+        if (!completion.last) {
+            // 流式响应的中间分块：立即发送，请求仍在计算线程中进行
+            conn.streamQueued += completion.response.header.size() + completion.response.body.size();
+            queueResponse(conn, std::move(completion.response));
+            updateDeadline(conn);
+            flushConnection(conn);
+            continue;
+        }
+
+        conn.busy = false;
+        conn.coalesced = false;
+        conn.stream.reset();
+        conn.streamQueued = 0;
+        if (conn.eventStream) {
+            // 事件流的最后一个事件，发送后关闭连接
+            conn.eventStream = false;
+            conn.eventStreamOpen->store(false, std::memory_order_release);
+        }
+        queueResponse(conn, std::move(completion.response));
+        finishRequest(conn);
+
+        // 计算期间暂停了接收，继续读取并处理缓冲中的后续请求
+        resumeConnection(conn);
+    }
+}
+
+Connection& Reactor::addConnection(int fd, const sockaddr* address, socklen_t addressLength) {
+    auto conn = std::make_unique<Connection>(options_.maxBodySize);
+    conn->fd = fd;
+    conn->id = nextConnectionId_++;
+    conn->clientKey = addressKey(address, addressLength, conn->trustedPeer);
+    conn->timer.key = static_cast<uint64_t>(fd);
+    Connection& result = *conn;
+    connections_[fd] = std::move(conn);
+
+    // 新连接在请求头期限内必须发来完整的请求头
+    updateDeadline(result);
+    return result;
+}
+
+void Reactor::processRequests(Connection& conn) {
+    // 流水线：依次处理缓冲中已完整到达的请求；
+    // 同一连接上的请求按顺序处理，上一个请求完成前不解析下一个
+    while (!conn.busy && !conn.closeAfterWrite) {
+        if (conn.spool) {
+            if (!continueSpool(conn)) {
+                break;
+            }
+            continue;
+        }
+
+        HttpRequest request;
+        ParseStatus status = conn.parser.parse(conn.input->readable(), request);
+        if (status == ParseStatus::Incomplete) {
+            // 请求头已解析完时按整个请求的长度一次性预留空间，超大的导入请求改为暂存到磁盘
+            if (conn.parser.requestLength() > 0) {
+                if (beginSpool(conn)) {
+                    continue;
+                }
+                conn.input->reserve(conn.parser.requestLength());
+            }
+            break;
+        }
+        if (status == ParseStatus::Error) {
+            queueResponse(conn, makeJsonResponse(json({
+                {"success", false},
+                {"error", conn.parser.errorMessage()}
+            }).dump(), false, conn.parser.errorStatus()));
+            conn.closeAfterWrite = true;
+            discardInput(conn);
+            break;
+        }
+
+        dispatchRequest(conn, request);
+        if (!conn.busy) {
+            finishRequest(conn);
+        }
+    }
+
+    updateDeadline(conn);
+}
+
+bool Reactor::beginSpool(Connection& conn) {
+    if (options_.spoolThreshold == 0) {
+        return false;
+    }
+    HttpRequest request;
+    if (!conn.parser.peekHeaders(conn.input->readable(), request) || request.method != "POST" ||
+        request.path != "/import-data" || request.contentLength < options_.spoolThreshold) {
+        return false;
+    }
+
+    // 临时文件创建失败时退回在内存中接收
+    std::unique_ptr<SpoolFile> file = SpoolFile::create(options_.spoolDir);
+    if (!file) {
+        return false;
+    }
+    auto spool = std::make_shared<SpooledRequest>();
+    spool->method = std::string(request.method);
+    spool->path = std::string(request.path);
+    spool->version = std::string(request.version);
+    spool->realIp = std::string(request.realIp);
+    spool->contentType = std::string(request.contentType);
+    spool->accept = std::string(request.accept);
+    spool->contentLength = request.contentLength;
+    spool->keepAlive = request.keepAlive;
+    spool->file = std::move(file);
+    conn.spool = std::move(spool);
+
+    // 请求头已拷贝，从缓冲中移除，之后缓冲里只有请求体的字节
+    conn.input->consume(conn.parser.headerLength());
+    conn.parser.reset();
+    return true;
+}
+
+bool Reactor::continueSpool(Connection& conn) {
+    SpooledRequest& spool = *conn.spool;
+    std::string_view available = conn.input->readable();
+    size_t chunk = std::min(available.size(), spool.contentLength - spool.file->size());
+    if (chunk > 0) {
+        bool written = spool.file->append(available.data(), chunk);
+        conn.input->consume(chunk);
+        if (!written) {
+            conn.spool.reset();
+            queueResponse(conn, makeJsonResponse(json({
+                {"success", false},
+                {"error", "服务器暂存请求体失败"}
+            }).dump(), false, "507 Insufficient Storage"));
+            conn.closeAfterWrite = true;
+            discardInput(conn);
+            return false;
+        }
+    }
+    if (spool.file->size() < spool.contentLength) {
+        return false;
+    }
+
+    std::shared_ptr<SpooledRequest> complete = std::move(conn.spool);
+    HttpRequest request;
+    request.method = complete->method;
+    request.path = complete->path;
+    request.version = complete->version;
+    request.realIp = complete->realIp;
+    request.contentType = complete->contentType;
+    request.accept = complete->accept;
+    request.contentLength = complete->contentLength;
+    request.keepAlive = complete->keepAlive;
+    dispatchRequest(conn, request, complete);
+    if (!conn.busy) {
+        finishRequest(conn);
+    }
+    return true;
+}
+
+void Reactor::updateDeadline(Connection& conn) {
+    // 根据连接所处阶段选择期限；阶段不变时保留原期限，
+    // 逐字节慢速发送请求头无法不断延长等待时间
+    TimerPhase phase;
+    if (conn.eventStream) {
+        phase = TimerPhase::Heartbeat;
+    } else if (conn.busy && conn.coalesced) {
+        // 合并的结果由另一个任务计算，不能无限期等下去
+        phase = TimerPhase::Coalesced;
+    } else if (conn.busy) {
+        // 计算期间只在有数据待发送时计时，期限随发送进度顺延
+        phase = conn.output.empty() ? TimerPhase::None : TimerPhase::Write;
+    } else if (conn.spool) {
+        phase = TimerPhase::Body;
+    } else if (conn.closeAfterWrite || (conn.input->empty() && conn.served)) {
+        phase = TimerPhase::Idle;
+    } else if (conn.parser.requestLength() > 0) {
+        phase = TimerPhase::Body;
+    } else {
+        phase = TimerPhase::Header;
+    }
+    if (phase == conn.timerPhase && (phase == TimerPhase::None || conn.timer.scheduled())) {
+        return;
+    }
+
+    conn.timerPhase = phase;
+    int timeoutMs = 0;
+    switch (phase) {
+    case TimerPhase::Header: timeoutMs = options_.headerTimeoutMs; break;
+    case TimerPhase::Body: timeoutMs = options_.bodyTimeoutMs; break;
+    case TimerPhase::Idle: timeoutMs = options_.idleTimeoutMs; break;
+    case TimerPhase::Write: timeoutMs = options_.writeTimeoutMs; break;
+    case TimerPhase::Heartbeat: timeoutMs = options_.heartbeatMs; break;
+    case TimerPhase::Coalesced: timeoutMs = options_.coalesceWaitMs; break;
+    case TimerPhase::None: break;
+    }
+    if (timeoutMs > 0) {
+        timers_.schedule(conn.timer, static_cast<uint64_t>(timeoutMs));
+    } else {
+        conn.timer.cancel();
+    }
+}
+
+void Reactor::expireTimers() {
+    timers_.advance([this](TimerNode& node) {
+        auto it = connections_.find(static_cast<int>(node.key));
+        if (it != connections_.end()) {
+            handleTimeout(*it->second);
+        }
+    });
+}
+
+void Reactor::handleTimeout(Connection& conn) {
+    TimerPhase phase = conn.timerPhase;
+    conn.timerPhase = TimerPhase::None;
+    if (phase == TimerPhase::Heartbeat) {
+        // SSE注释行，客户端忽略；写入失败时连接随之关闭
+        updateDeadline(conn);
+        HttpResponse heartbeat;
+        heartbeat.body = ": heartbeat\n\n";
+        queueResponse(conn, std::move(heartbeat));
+        flushConnection(conn);
+        return;
+    }
+    if (phase == TimerPhase::Write) {
+        // 客户端发出请求后不再读取响应，关闭连接，不让它无限期占用连接和发送缓冲。
+        // io_uring下连接可能因未完成的操作延迟析构，先中止流式响应，立即放出计算线程
+        if (conn.stream) {
+            conn.stream->abort();
+        }
+        closeConnection(conn.fd);
+        return;
+    }
+    if (phase == TimerPhase::Coalesced) {
+        // 换一个连接序号，迟到的合并结果按已关闭的连接丢弃，不会在503之后再发送一次
+        conn.id = nextConnectionId_++;
+        conn.busy = false;
+        conn.coalesced = false;
+        rejectWithRetry(conn, false, "503 Service Unavailable", "计算超时，请稍后重试",
+                        admission_.retryAfterSeconds());
+        conn.closeAfterWrite = true;
+        discardInput(conn);
+        updateDeadline(conn);
+        flushConnection(conn);
+        return;
+    }
+    if (phase == TimerPhase::Idle || (phase == TimerPhase::Header && conn.input->empty())) {
+        // 空闲的长连接或从未发送数据的连接直接关闭
+        closeConnection(conn.fd);
+        return;
+    }
+
+    // 请求接收到一半超时，回复408后关闭
+    conn.spool.reset();
+    queueResponse(conn, makeJsonResponse(json({
+        {"success", false},
+        {"error", "请求超时"}
+    }).dump(), false, "408 Request Timeout"));
+    conn.closeAfterWrite = true;
+    discardInput(conn);
+    // 客户端不读取408时按空闲期限关闭
+    updateDeadline(conn);
+    flushConnection(conn);
+}
+
+void Reactor::dispatchRequest(Connection& conn, const HttpRequest& request,
+                              std::shared_ptr<SpooledRequest> spool) {
+    // 停止期间收到的请求照常处理，但应答后关闭连接
+    bool keepAlive = request.keepAlive && !draining_.load(std::memory_order_acquire);
+    if (!keepAlive) {
+        conn.closeAfterWrite = true;
+    }
+
+    if (request.method == "OPTIONS") {
+        // 处理CORS预检请求
+        queueResponse(conn, makeJsonResponse("{}", keepAlive));
+        return;
+    }
+    if (request.method == "GET" && handleProbe(conn, request, keepAlive)) {
+        return;
+    }
+    if (request.method == "GET" && request.path == kControlChartStreamPath) {
+        auto subscribe = [this](EventSubscriber subscriber, std::shared_ptr<const std::atomic<bool>> open) {
+            apiHandler_.subscribeControlChart([subscriber](const std::string& event) {
+                return subscriber(event, false);
+            }, std::move(open));
+        };
+        // 连接关闭时立即移除订阅者，不必等到下一次数据变化
+        openEventStream(conn, keepAlive, subscribe, true, [this] {
+            apiHandler_.pruneControlChartSubscribers();
+        });
+        return;
+    }
+    if (request.method == "GET" && request.path.compare(0, kJobsPrefix.size(), kJobsPrefix) == 0) {
+        handleJobQuery(conn, request, keepAlive);
+        return;
+    }
+    if (request.method != "POST") {
+        queueResponse(conn, makeJsonResponse("{\"error\": \"仅支持POST请求\"}", keepAlive));
+        return;
+    }
+
+    // 统计计算交给计算线程池，避免阻塞事件循环上的其他连接；
+    // 任务持有接收缓冲的引用，请求体直接以string_view交给ApiHandler
+    int fd = conn.fd;
+    uint64_t connectionId = conn.id;
+    std::string path(request.path);
+
+    // /jobs/<接口>以异步任务方式执行该接口，限流和准入按接口本身计算
+    bool asJob = path.compare(0, kJobsPrefix.size(), kJobsPrefix) == 0;
+    if (asJob) {
+        path.erase(0, kJobsPrefix.size() - 1);
+        if (!apiHandler_.hasRoute(path)) {
+            queueResponse(conn, makeJsonResponse(json({
+                {"success", false},
+                {"error", "路由不存在: " + path}
+            }).dump(), keepAlive, "404 Not Found"));
+            return;
+        }
+    }
+
+    // 按客户端限流：解析请求体之前按接口权重扣除令牌，请求过于频繁的客户端得到429；
+    // 经本机反向代理转发的请求按代理传来的真实地址计算
+    uint64_t clientKey = conn.clientKey;
+    if (conn.trustedPeer && !request.realIp.empty()) {
+        clientKey = textAddressKey(request.realIp);
+    }
+    int throttled = rateLimiter_.tryConsume(clientKey, RateLimiter::endpointCost(path));
+    if (throttled > 0) {
+        rejectWithRetry(conn, keepAlive, "429 Too Many Requests", "请求过于频繁，请稍后重试", throttled);
+        return;
+    }
+    if (!asJob && !spool && coalesceRequest(conn, request, path, keepAlive)) {
+        return;
+    }
+
+    // 按接口和数据规模估算代价，超出预算的请求不进入队列直接拒绝；
+    // 许可随任务传递，任务结束或被丢弃时归还预算
+    uint64_t cost = AdmissionController::estimateCost(path, request.contentLength, apiHandler_.sampleCount(),
+                                                      requestedSamples(path, request));
+    if (!admission_.tryAdmit(cost)) {
+        rejectWithRetry(conn, keepAlive, "503 Service Unavailable", "服务器繁忙，请稍后重试",
+                        admission_.retryAfterSeconds());
+        return;
+    }
+    auto ticket = std::make_shared<AdmissionTicket>(admission_, cost);
+    if (asJob) {
+        submitJob(conn, request, path, std::move(ticket), keepAlive);
+        return;
+    }
+
+    // 按Accept-Encoding协商响应压缩，直连客户端和nginx回环一跳都只传输压缩后的字节
+    ContentEncoding encoding = options_.compressionLevel > 0
+        ? negotiateEncoding(request.acceptEncoding) : ContentEncoding::Identity;
+    // 请求体按Content-Type解析，响应体按Accept选择JSON、CBOR或MessagePack
+    BodyFormat requestFormat = requestBodyFormat(request.contentType);
+    BodyFormat responseFormat = negotiateBodyFormat(request.accept);
+
+    ThreadPool::Task task;
+    if (spool) {
+        // 暂存的请求体整体映射为只读内存，以SAX方式直接解析进数据集
+        task = [this, fd, connectionId, path, spool, ticket, keepAlive, requestFormat, responseFormat]() {
+            std::string_view body = spool->file->map();
+            std::string result = body.size() == spool->contentLength
+                ? apiHandler_.handleRequest(path, body, requestFormat, responseFormat)
+                : encodeValue(json({{"success", false}, {"error", "读取暂存的请求体失败"}}), responseFormat);
+            postCompletion(fd, connectionId, makeApiResponse(std::move(result), keepAlive,
+                                                             ContentEncoding::Identity, responseFormat));
+        };
+    } else if (request.version == "HTTP/1.1" && apiHandler_.isStreamingRoute(path)) {
+        // 大结果以分块传输边生成边发送，CBOR/MessagePack同样直接编码进分块；
+        // HTTP/1.0客户端不支持分块，仍整体返回
+        auto stream = std::make_shared<ResponseStream>(*this, fd, connectionId, keepAlive,
+                                                       options_.streamBacklog, options_.writeTimeoutMs,
+                                                       responseFormat, encoding,
+                                                       options_.compressionLevel,
+                                                       options_.compressionThreshold);
+        conn.stream = stream;
+        task = [this, stream, path, request, buffer = conn.input, ticket, requestFormat, responseFormat]() {
+            bool ok = false;
+            try {
+                ok = apiHandler_.handleStreamingRequest(path, request.body, *stream, requestFormat, responseFormat);
+            } catch (const std::exception& e) {
+                std::cerr << "流式响应出错: " << e.what() << std::endl;
+            }
+            stream->finish(ok);
+        };
+    } else {
+        task = [this, fd, connectionId, path, request, buffer = conn.input, ticket, keepAlive, encoding,
+                requestFormat, responseFormat]() {
+            HttpResponse response = makeApiResponse(
+                apiHandler_.handleRequest(path, request.body, requestFormat, responseFormat),
+                keepAlive, encoding, responseFormat);
+            postCompletion(fd, connectionId, std::move(response));
+        };
+    }
+
+    if (!computePool_.trySubmit(std::move(task))) {
+        conn.stream.reset();
+        admission_.recordShed();
+        rejectWithRetry(conn, keepAlive, "503 Service Unavailable", "服务器繁忙，请稍后重试",
+                        admission_.retryAfterSeconds());
+        return;
+    }
+    conn.busy = true;
+}
+
+// 负责计算的任务抛出异常、或在线程池关闭时未执行就被丢弃，析构时以500结束这次合并；
+// 否则之后相同的请求都会登记在一个永远不会完成的计算下
+class Reactor::FlightGuard {
+public:
+    FlightGuard(const Reactor& reactor, std::string key) : reactor_(reactor), key_(std::move(key)) {}
+
+    ~FlightGuard() {
+        if (completed_) {
+            return;
+        }
+        try {
+            complete(json({
+                {"success", false},
+                {"error", "服务器内部错误"}
+            }).dump(), "500 Internal Server Error");
+        } catch (const std::exception& e) {
+            std::cerr << "结束合并请求出错: " << e.what() << std::endl;
+        }
+    }
+
+    FlightGuard(const FlightGuard&) = delete;
+    FlightGuard& operator=(const FlightGuard&) = delete;
+
+    void complete(std::string body, const char* status, const std::string& extraHeaders = std::string(),
+                  BodyFormat format = BodyFormat::Json) {
+        // completeCoalesced先取出全部等待者，中途失败也不会再次投递
+        completed_ = true;
+        reactor_.completeCoalesced(key_, std::move(body), status, extraHeaders, format);
+    }
+
+    // 超出准入预算或任务队列已满
+    void reject(int retryAfter) {
+        complete(json({
+            {"success", false},
+            {"error", "服务器繁忙，请稍后重试"},
+            {"retryAfter", retryAfter}
+        }).dump(), "503 Service Unavailable", "Retry-After: " + std::to_string(retryAfter) + "\r\n");
+    }
+
+private:
+    const Reactor& reactor_;
+    std::string key_;
+    bool completed_ = false;
+};
+
+bool Reactor::coalesceRequest(Connection& conn, const HttpRequest& request, const std::string& path,
+                              bool keepAlive) {
+    // HTTP/1.1的流式接口边生成边发送，内存和首字节时间都有界，不为合并而整体生成
+    if (!options_.coalesceRequests || !apiHandler_.isReadOnlyRoute(path) ||
+        request.body.size() > kMaxCoalescedBody ||
+        (request.version == "HTTP/1.1" && apiHandler_.isStreamingRoute(path))) {
+        return false;
+    }
+
+    // 键由接口、规范化的请求参数（去掉空白、键按字典序）、响应格式和数据集版本组成，
+    // 数据更新后到达的请求不会拿到旧数据的结果；请求体格式错误时照常处理并报错
+    json params;
+    try {
+        params = decodeBody(request.body, requestBodyFormat(request.contentType));
+    } catch (const json::exception&) {
+        return false;
+    }
+    BodyFormat responseFormat = negotiateBodyFormat(request.accept);
+    std::string key = path;
+    key += '\0';
+    key += params.dump();
+    key += '\0';
+    key += mediaType(responseFormat);
+    key += '\0';
+    key += std::to_string(apiHandler_.dataVersion());
+
+    ContentEncoding encoding = options_.compressionLevel > 0
+        ? negotiateEncoding(request.acceptEncoding) : ContentEncoding::Identity;
+    conn.busy = true;
+    conn.coalesced = true;
+    if (!coalescer_.join(key, {this, conn.fd, conn.id, keepAlive, encoding})) {
+        // 相同的请求正在计算，结果由负责计算的请求完成时一并投递
+        return true;
+    }
+
+    auto flight = std::make_shared<FlightGuard>(*this, std::move(key));
+    uint64_t cost = AdmissionController::estimateCost(path, request.contentLength, apiHandler_.sampleCount());
+    if (!admission_.tryAdmit(cost)) {
+        flight->reject(admission_.retryAfterSeconds());
+        return true;
+    }
+    auto ticket = std::make_shared<AdmissionTicket>(admission_, cost);
+
+    // 合并的结果要发给多个连接，整体生成后再发送（流式接口只有HTTP/1.0请求会走到这里）；
+    // 请求参数已在计算键时解析，计算线程直接使用，不再解析请求体
+    ThreadPool::Task task = [this, flight, path, params = std::move(params), ticket, responseFormat]() {
+        flight->complete(apiHandler_.handleParsedRequest(path, params, responseFormat), "200 OK",
+                         std::string(), responseFormat);
+    };
+    if (!computePool_.trySubmit(std::move(task))) {
+        admission_.recordShed();
+        flight->reject(admission_.retryAfterSeconds());
+    }
+    return true;
+}
+
+void Reactor::completeCoalesced(const std::string& key, std::string body, const char* status,
+                                const std::string& extraHeaders, BodyFormat format) const {
+    std::vector<RequestCoalescer::Waiter> waiters = coalescer_.complete(key);
+    std::string formatHeaders = extraHeaders + renderVaryHeader(options_.compressionLevel > 0);
+    const char* contentType = mediaType(format);
+    auto identity = std::make_shared<const std::string>(std::move(body));
+    std::shared_ptr<const std::string> encoded[3];
+    bool compressible = identity->size() >= options_.compressionThreshold;
+
+    for (const RequestCoalescer::Waiter& waiter : waiters) {
+        std::shared_ptr<const std::string> payload = identity;
+        std::string headers = formatHeaders;
+        if (compressible && waiter.encoding != ContentEncoding::Identity) {
+            std::shared_ptr<const std::string>& slot = encoded[static_cast<int>(waiter.encoding)];
+            if (!slot) {
+                try {
+                    slot = std::make_shared<const std::string>(
+                        compressBody(*identity, waiter.encoding, options_.compressionLevel));
+                } catch (const std::exception& e) {
+                    std::cerr << "压缩响应出错: " << e.what() << std::endl;
+                    slot = identity;
+                }
+            }
+            if (slot != identity) {
+                payload = slot;
+                headers += contentEncodingHeader(waiter.encoding);
+            }
+        }
+        HttpResponse response;
+        // 等待者所在的Reactor可能在计算期间开始停止
+        bool keepAlive = waiter.keepAlive && !waiter.reactor->draining();
+        response.header = renderResponseHeader(payload->size(), keepAlive, status, headers, contentType);
+        response.sharedBody = std::move(payload);
+        waiter.reactor->postCompletion(waiter.fd, waiter.connectionId, std::move(response));
+    }
+}
+
+void Reactor::openEventStream(Connection& conn, bool keepAlive, EventSubscription subscribe, bool onComputePool,
+                              std::function<void()> onClose) {
+    // 事件由产生事件的线程经完成队列送回本线程发送，连接一直保持忙碌状态，不再解析请求
+    int fd = conn.fd;
+    uint64_t connectionId = conn.id;
+    auto open = std::make_shared<std::atomic<bool>>(true);
+    EventSubscriber subscriber = [this, fd, connectionId, open](const std::string& event, bool last) {
+        if (!open->load(std::memory_order_acquire)) {
+            return false;
+        }
+        HttpResponse response;
+        response.body = event;
+        postCompletion(fd, connectionId, std::move(response), last);
+        return true;
+    };
+    if (onComputePool) {
+        ThreadPool::Task task = [subscribe, subscriber, open]() {
+            subscribe(subscriber, open);
+        };
+        if (!computePool_.trySubmit(std::move(task))) {
+            admission_.recordShed();
+            rejectWithRetry(conn, keepAlive, "503 Service Unavailable", "服务器繁忙，请稍后重试",
+                            admission_.retryAfterSeconds());
+            return;
+        }
+    }
+
+    HttpResponse header;
+    header.header = renderEventStreamHeader();
+    queueResponse(conn, std::move(header));
+    conn.eventStream = true;
+    conn.eventStreamOpen = open;
+    conn.onClose = std::move(onClose);
+    conn.busy = true;
+    conn.closeAfterWrite = true;
+    if (!onComputePool) {
+        subscribe(std::move(subscriber), std::move(open));
+    }
+}
+
+void Reactor::submitJob(Connection& conn, const HttpRequest& request, const std::string& path,
+                        std::shared_ptr<AdmissionTicket> ticket, bool keepAlive) {
+    // 结果直接按提交时Accept协商的格式生成，取结果时不再转换
+    std::shared_ptr<Job> job = jobs_.create(path, negotiateBodyFormat(request.accept));
+    if (!job) {
+        rejectWithRetry(conn, keepAlive, "503 Service Unavailable", "未完成的异步任务过多，请稍后重试",
+                        admission_.retryAfterSeconds());
+        return;
+    }
+
+    // 连接在提交后立即空闲，请求体拷贝一份随任务保存
+    BodyFormat format = requestBodyFormat(request.contentType);
+    ThreadPool::Task task = [this, job, body = std::string(request.body), format, ticket]() {
+        job->start();
+        if (apiHandler_.isStreamingRoute(job->path())) {
+            JobSink sink(*job);
+            bool ok = false;
+            try {
+                ok = apiHandler_.handleStreamingRequest(job->path(), body, sink, format, job->format());
+            } catch (const std::exception& e) {
+                std::cerr << "异步任务出错: " << e.what() << std::endl;
+            }
+            job->finish(sink.take(), ok);
+        } else {
+            job->finish(apiHandler_.handleRequest(job->path(), body, format, job->format()), true);
+        }
+    };
+    if (!computePool_.trySubmit(std::move(task))) {
+        jobs_.remove(job->id());
+        admission_.recordShed();
+        rejectWithRetry(conn, keepAlive, "503 Service Unavailable", "服务器繁忙，请稍后重试",
+                        admission_.retryAfterSeconds());
+        return;
+    }
+
+    std::string statusPath = std::string(kJobsPrefix) + job->id();
+    queueResponse(conn, makeJsonResponse(json({
+        {"success", true},
+        {"jobId", job->id()},
+        {"status", "queued"},
+        {"statusUrl", statusPath},
+        {"resultUrl", statusPath + "/result"},
+        {"eventsUrl", statusPath + "/events"},
+        {"ttlMs", jobs_.ttlMs()}
+    }).dump(), keepAlive, "202 Accepted", "Location: " + statusPath + "\r\n"));
+}
+
+void Reactor::handleJobQuery(Connection& conn, const HttpRequest& request, bool keepAlive) {
+    std::string_view rest = request.path.substr(kJobsPrefix.size());
+    size_t slash = rest.find('/');
+    std::string_view id = rest.substr(0, slash);
+    std::string_view action = slash == std::string_view::npos ? std::string_view() : rest.substr(slash + 1);
+
+    std::shared_ptr<Job> job = jobs_.find(id);
+    if (!job || (action != "" && action != "result" && action != "events")) {
+        queueResponse(conn, jobNotFound(keepAlive));
+        return;
+    }
+    if (action.empty()) {
+        queueResponse(conn, makeJsonResponse(job->statusJson(), keepAlive));
+        return;
+    }
+    if (action == "events") {
+        openEventStream(conn, keepAlive, [job](EventSubscriber subscriber, std::shared_ptr<const std::atomic<bool>>) {
+            job->subscribe(std::move(subscriber));
+        }, false);
+        return;
+    }
+
+    std::shared_ptr<const std::string> result = job->result();
+    if (!result) {
+        // 尚未完成，返回当前状态
+        queueResponse(conn, makeJsonResponse(job->statusJson(), keepAlive, "202 Accepted"));
+        return;
+    }
+
+    // 结果可能很大，拷贝和压缩放在计算线程中进行
+    int fd = conn.fd;
+    uint64_t connectionId = conn.id;
+    ContentEncoding encoding = options_.compressionLevel > 0
+        ? negotiateEncoding(request.acceptEncoding) : ContentEncoding::Identity;
+    BodyFormat format = job->format();
+    ThreadPool::Task task = [this, fd, connectionId, result, keepAlive, encoding, format]() {
+        postCompletion(fd, connectionId, makeApiResponse(*result, keepAlive, encoding, format));
+    };
+    if (!computePool_.trySubmit(std::move(task))) {
+        admission_.recordShed();
+        rejectWithRetry(conn, keepAlive, "503 Service Unavailable", "服务器繁忙，请稍后重试",
+                        admission_.retryAfterSeconds());
+        return;
+    }
+    conn.busy = true;
+}
+
+HttpResponse Reactor::makeApiResponse(std::string body, bool keepAlive, ContentEncoding encoding,
+                                      BodyFormat format) const {
+    std::string headers = renderVaryHeader(options_.compressionLevel > 0);
+    if (encoding != ContentEncoding::Identity && body.size() >= options_.compressionThreshold) {
+        try {
+            body = compressBody(body, encoding, options_.compressionLevel);
+            headers += contentEncodingHeader(encoding);
+        } catch (const std::exception& e) {
+            std::cerr << "压缩响应出错: " << e.what() << std::endl;
+        }
+    }
+    HttpResponse response;
+    response.header = renderResponseHeader(body.size(), keepAlive && !draining(), "200 OK", headers,
+                                           mediaType(format));
+    response.body = std::move(body);
+    return response;
+}
+
+void Reactor::rejectWithRetry(Connection& conn, bool keepAlive, const char* status, const char* message,
+                              int retryAfter) {
+    queueResponse(conn, makeJsonResponse(json({
+        {"success", false},
+        {"error", message},
+        {"retryAfter", retryAfter}
+    }).dump(), keepAlive, status, "Retry-After: " + std::to_string(retryAfter) + "\r\n"));
+}
+
+bool Reactor::handleProbe(Connection& conn, const HttpRequest& request, bool keepAlive) {
+    std::string_view path = request.path.substr(0, request.path.find('?'));
+
+    // 探针直接在事件循环中应答，不经过JSON解析和计算线程池，分析任务再多也不会拖慢探针
+    if (path == "/health") {
+        queueResponse(conn, probeResponse(ProbeState::Healthy, keepAlive));
+        return true;
+    }
+    if (path == "/ready") {
+        // 任务队列已满时新的分析请求只会得到503，此时报告未就绪让负载均衡暂时摘除本实例
+        ProbeState state;
+        if (draining_.load(std::memory_order_acquire)) {
+            state = ProbeState::Draining;
+        } else if (computePool_.queueDepth() >= computePool_.queueCapacity()) {
+            state = ProbeState::Saturated;
+        } else if (apiHandler_.hasData()) {
+            state = ProbeState::Ready;
+        } else {
+            state = ProbeState::ReadyNoData;
+        }
+        queueResponse(conn, probeResponse(state, keepAlive));
+        return true;
+    }
+    if (path == "/metrics") {
+        queueResponse(conn, makeJsonResponse(json({
+            {"admitted", admission_.admittedCount()},
+            {"shed", admission_.shedCount()},
+            {"throttled", rateLimiter_.throttledCount()},
+            {"inFlightCost", admission_.inFlightCost()},
+            {"admissionBudget", admission_.budget()},
+            {"queueDepth", computePool_.queueDepth()},
+            {"queueCapacity", computePool_.queueCapacity()},
+            {"jobs", jobs_.size()},
+            {"coalesced", coalescer_.coalescedCount()}
+        }).dump(), keepAlive));
+        return true;
+    }
+    return false;
+}
+
+void Reactor::queueResponse(Connection& conn, HttpResponse response) {
+    if (response.closeAfterSend) {
+        conn.closeAfterWrite = true;
+    }
+    // 响应头和响应体作为两个数据块入队，发送时由writev拼接
+    conn.output.append(std::move(response.header));
+    if (response.sharedBody) {
+        conn.output.append(std::move(response.sharedBody));
+    } else {
+        conn.output.append(std::move(response.body));
+    }
+}
+
+void Reactor::reportWriteProgress(Connection& conn) {
+    // 客户端仍在读取响应时顺延空闲或发送期限，慢速下载大响应不会被误判为停滞
+    if (conn.timerPhase == TimerPhase::Idle && options_.idleTimeoutMs > 0) {
+        timers_.schedule(conn.timer, static_cast<uint64_t>(options_.idleTimeoutMs));
+    } else if (conn.timerPhase == TimerPhase::Write) {
+        if (conn.output.empty()) {
+            // 已全部写出，计算期间不再计时，直到下一个分块入队
+            conn.timerPhase = TimerPhase::None;
+            conn.timer.cancel();
+        } else if (options_.writeTimeoutMs > 0) {
+            timers_.schedule(conn.timer, static_cast<uint64_t>(options_.writeTimeoutMs));
+        }
+    }
+
+    if (!conn.stream) {
+        return;
+    }
+    // 流式分块总在发送队列末尾，队列中剩余字节以外的部分都已写入套接字
+    size_t unsent = std::min(conn.streamQueued, conn.output.pendingBytes());
+    size_t written = conn.streamQueued - unsent;
+    if (written > 0) {
+        conn.streamQueued = unsent;
+        conn.stream->release(written);
+    }
+}
+
+void Reactor::finishRequest(Connection& conn) {
+    conn.served = true;
+    if (draining_.load(std::memory_order_acquire)) {
+        // 停止开始前已分派的请求，应答后同样关闭连接
+        conn.closeAfterWrite = true;
+    }
+    // 丢弃已处理请求占用的字节，解析器回到请求行状态
+    conn.input->consume(conn.parser.requestLength());
+    conn.parser.reset();
+}
+
+} // namespace QualityManagement
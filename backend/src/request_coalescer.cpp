@@ -0,0 +1,26 @@
+#include "../include/request_coalescer.h"
+
+namespace QualityManagement {
+
+bool RequestCoalescer::join(const std::string& key, const Waiter& waiter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto result = flights_.try_emplace(key);
+    result.first->second.push_back(waiter);
+    if (!result.second) {
+        coalesced_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result.second;
+}
+
+std::vector<RequestCoalescer::Waiter> RequestCoalescer::complete(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = flights_.find(key);
+    if (it == flights_.end()) {
+        return {};
+    }
+    std::vector<Waiter> waiters = std::move(it->second);
+    flights_.erase(it);
+    return waiters;
+}
+
+} // namespace QualityManagement
@@ -0,0 +1,123 @@
+#include "../include/response_stream.h"
+#include "../include/reactor.h"
+#include <algorithm>
+
+namespace QualityManagement {
+
+ResponseStream::ResponseStream(Reactor& reactor, int fd, uint64_t connectionId, bool keepAlive, size_t maxBacklog,
+                               int writeTimeoutMs, BodyFormat format, ContentEncoding encoding,
+                               int compressionLevel, size_t compressionThreshold)
+    : reactor_(reactor), fd_(fd), connectionId_(connectionId), keepAlive_(keepAlive),
+      maxBacklog_(std::max<size_t>(1, maxBacklog)), writeTimeout_(std::max(0, writeTimeoutMs)), format_(format),
+      encoding_(encoding),
+      compressionLevel_(compressionLevel), compressionThreshold_(compressionThreshold) {
+}
+
+bool ResponseStream::write(std::string chunk) {
+    if (chunk.empty()) {
+        return true;
+    }
+    if (encoding_ == ContentEncoding::Identity) {
+        return send(std::move(chunk));
+    }
+
+    if (!compressor_) {
+        pending_ += chunk;
+        if (pending_.size() < compressionThreshold_) {
+            return true;
+        }
+        compressor_ = std::make_unique<Compressor>(encoding_, compressionLevel_);
+        chunk = std::move(pending_);
+        pending_.clear();
+    }
+    std::string compressed;
+    compressor_->compress(chunk, false, compressed);
+    return send(std::move(compressed));
+}
+
+bool ResponseStream::send(std::string chunk) {
+    if (chunk.empty()) {
+        // 压缩器暂时没有输出，仍然让计算线程及时发现客户端已断开
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !aborted_;
+    }
+
+    HttpResponse response;
+    if (!started_) {
+        std::string headers = renderVaryHeader(compressionLevel_ > 0);
+        if (compressor_) {
+            headers += contentEncodingHeader(encoding_);
+        }
+        response.header = renderChunkedHeader(keepAlive_ && !reactor_.draining(), "200 OK", headers,
+                                              mediaType(format_));
+    }
+    response.header += renderChunkPrefix(chunk.size(), !started_);
+    response.body = std::move(chunk);
+    started_ = true;
+
+    size_t size = response.header.size() + response.body.size();
+    {
+        // 积压过多时等待Reactor把之前的分块写入套接字；
+        // 一个期限内毫无进展说明客户端已停止读取，放弃而不是无限期占住计算线程
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!aborted_ && backlog_ >= maxBacklog_) {
+            if (writeTimeout_.count() == 0) {
+                condition_.wait(lock);
+                continue;
+            }
+            size_t before = backlog_;
+            if (condition_.wait_for(lock, writeTimeout_) == std::cv_status::timeout && backlog_ == before) {
+                aborted_ = true;
+            }
+        }
+        if (aborted_) {
+            return false;
+        }
+        backlog_ += size;
+    }
+
+    reactor_.postCompletion(fd_, connectionId_, std::move(response), false);
+    return true;
+}
+
+void ResponseStream::finish(bool ok) {
+    if (ok && compressor_) {
+        std::string tail;
+        compressor_->compress(std::string_view(), true, tail);
+        ok = send(std::move(tail));
+    } else if (ok && !pending_.empty()) {
+        // 总量不足压缩阈值，原样发出
+        ok = send(std::move(pending_));
+    }
+
+    HttpResponse response;
+    if (ok) {
+        if (!started_) {
+            response.header = renderChunkedHeader(keepAlive_ && !reactor_.draining(), "200 OK",
+                                                  renderVaryHeader(compressionLevel_ > 0), mediaType(format_));
+        }
+        response.header += renderLastChunk(!started_);
+    } else {
+        // 响应头已发出，无法再改为错误响应，只能断开连接让客户端感知
+        response.closeAfterSend = true;
+    }
+    reactor_.postCompletion(fd_, connectionId_, std::move(response), true);
+}
+
+void ResponseStream::release(size_t count) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        backlog_ -= std::min(count, backlog_);
+    }
+    condition_.notify_one();
+}
+
+void ResponseStream::abort() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborted_ = true;
+    }
+    condition_.notify_one();
+}
+
+} // namespace QualityManagement
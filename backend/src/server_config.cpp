@@ -0,0 +1,316 @@
+#include "../include/server_config.h"
+#include "../include/nlohmann/json.hpp"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace QualityManagement {
+
+using json = nlohmann::json;
+
+namespace {
+
+// 把文本解析为[minValue, maxValue]内的整数并乘以scale，整个字符串都必须是数字
+template <typename T>
+bool parseInteger(const std::string& text, T& target, long long minValue, long long maxValue, uint64_t scale = 1) {
+    if (text.empty()) {
+        return false;
+    }
+    size_t used = 0;
+    long long value;
+    try {
+        value = std::stoll(text, &used);
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (used != text.size() || value < minValue || value > maxValue) {
+        return false;
+    }
+    target = static_cast<T>(static_cast<uint64_t>(value) * scale);
+    return true;
+}
+
+bool parseBool(const std::string& text, bool& target) {
+    if (text == "1" || text == "true" || text == "yes" || text == "on") {
+        target = true;
+        return true;
+    }
+    if (text == "0" || text == "false" || text == "no" || text == "off") {
+        target = false;
+        return true;
+    }
+    return false;
+}
+
+const long long kMaxInt = std::numeric_limits<int>::max();
+
+// 一个配置项：命令行参数名（配置文件的键相同），说明，以及把文本值写入配置的函数
+struct OptionSpec {
+    const char* name;
+    const char* help;
+    bool isFlag;                  // 布尔开关，命令行中可以不带值
+    std::function<bool(RuntimeConfig&, const std::string&)> apply;
+};
+
+const std::vector<OptionSpec>& optionSpecs() {
+    static const std::vector<OptionSpec> specs = {
+        {"port", "TCP监听端口", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.port, 1, 65535);
+        }},
+        {"bind", "TCP监听地址", false, [](RuntimeConfig& c, const std::string& v) {
+            c.server.bindAddress = v;
+            return !v.empty();
+        }},
+        {"unix-socket", "额外监听的Unix域套接字路径", false, [](RuntimeConfig& c, const std::string& v) {
+            c.server.unixSocketPath = v;
+            return true;
+        }},
+        {"reuseport", "每个事件循环使用独立的SO_REUSEPORT监听套接字", true, [](RuntimeConfig& c, const std::string& v) {
+            return parseBool(v, c.server.reusePort);
+        }},
+        {"io-backend", "I/O后端：epoll或io_uring", false, [](RuntimeConfig& c, const std::string& v) {
+            if (v == "epoll") {
+                c.server.ioBackend = IoBackend::Epoll;
+            } else if (v == "io_uring") {
+                c.server.ioBackend = IoBackend::IoUring;
+            } else {
+                return false;
+            }
+            return true;
+        }},
+        {"io-threads", "事件循环线程数，0表示按CPU核心数", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.ioThreads, 0, 1024);
+        }},
+        {"worker-threads", "统计计算线程数，0表示按CPU核心数", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.workerThreads, 0, 1024);
+        }},
+        {"worker-queue-depth", "计算任务队列上限", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.workerQueueDepth, 1, kMaxInt);
+        }},
+        {"read-buffer-kb", "单次接收的最大字节数（KB）", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.readChunkSize, 1, 4096, 1024);
+        }},
+        {"uring-entries", "io_uring提交队列槽位数", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.uringEntries, 64, 32768);
+        }},
+        {"uring-fixed-buffers", "每个io_uring事件循环注册的固定缓冲数", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.uringFixedBuffers, 0, 16384);
+        }},
+        {"stream-backlog-kb", "单个流式响应允许积压的最大字节数（KB）", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.streamBacklog, 1, kMaxInt, 1024);
+        }},
+        {"compression-level", "响应gzip/deflate压缩级别（1-9），0表示不压缩", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.compressionLevel, 0, 9);
+        }},
+        {"compression-min-bytes", "响应体达到该字节数才压缩", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.compressionThreshold, 0, kMaxInt);
+        }},
+        {"max-body-mb", "单个请求体上限（MB）", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.maxBodySize, 1, 1024 * 1024, 1024 * 1024);
+        }},
+        {"spool-threshold-mb", "/import-data请求体达到该大小（MB）时暂存到磁盘，0表示不暂存", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.spoolThreshold, 0, 1024 * 1024, 1024 * 1024);
+        }},
+        {"spool-dir", "暂存超大请求体的目录", false, [](RuntimeConfig& c, const std::string& v) {
+            c.server.spoolDir = v;
+            return !v.empty();
+        }},
+        {"admission-budget-m", "准入预算（百万样本点），0表示不限制", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.admissionBudget, 0, 1000 * 1000, 1000 * 1000);
+        }},
+        {"rate-limit-rps", "每个客户端每秒补充的令牌数，0表示不限流", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.rateLimitRps, 0, 1000000);
+        }},
+        {"rate-limit-burst", "每个客户端的令牌桶容量", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.rateLimitBurst, 1, 1000000);
+        }},
+        {"header-timeout-ms", "接收完整请求头的期限（毫秒），0表示不限制", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.headerTimeoutMs, 0, kMaxInt);
+        }},
+        {"body-timeout-ms", "接收完整请求体的期限（毫秒），0表示不限制", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.bodyTimeoutMs, 0, kMaxInt);
+        }},
+        {"idle-timeout-ms", "长连接空闲的期限（毫秒），0表示不限制", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.idleTimeoutMs, 0, kMaxInt);
+        }},
+        {"write-timeout-ms", "响应发送期间客户端不读取数据的期限（毫秒），0表示不限制", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.writeTimeoutMs, 0, kMaxInt);
+        }},
+        {"heartbeat-ms", "事件流连接的心跳间隔（毫秒）", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.heartbeatMs, 1000, kMaxInt);
+        }},
+        {"job-ttl-s", "异步任务结果的保留时间（秒）", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.jobTtlSeconds, 1, 7 * 24 * 3600);
+        }},
+        {"max-jobs", "同时保留的异步任务数上限", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.maxJobs, 1, 1000000);
+        }},
+        {"coalesce", "合并相同的并发分析请求，只计算一次（默认开启，off关闭）", true, [](RuntimeConfig& c, const std::string& v) {
+            return parseBool(v, c.server.coalesceRequests);
+        }},
+        {"coalesce-wait-ms", "合并的请求等待计算结果的期限（毫秒），0表示不限制", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.coalesceWaitMs, 0, kMaxInt);
+        }},
+        {"drain-timeout-ms", "优雅停止时等待进行中请求的期限（毫秒）", false, [](RuntimeConfig& c, const std::string& v) {
+            return parseInteger(v, c.server.drainTimeoutMs, 0, kMaxInt);
+        }},
+        {"state-file", "退出前保存、启动时恢复数据集的文件", false, [](RuntimeConfig& c, const std::string& v) {
+            c.stateFile = v;
+            return true;
+        }},
+    };
+    return specs;
+}
+
+const OptionSpec* findOption(const std::string& name) {
+    for (const auto& spec : optionSpecs()) {
+        if (name == spec.name) {
+            return &spec;
+        }
+    }
+    return nullptr;
+}
+
+// 参数名对应的环境变量：加QMS_前缀，转大写，-换成_
+std::string envName(const std::string& name) {
+    std::string result = "QMS_";
+    for (char ch : name) {
+        result += ch == '-' ? '_' : static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+    }
+    return result;
+}
+
+bool applyOption(const OptionSpec& spec, RuntimeConfig& config, const std::string& value, const std::string& source) {
+    if (!spec.apply(config, value)) {
+        std::cerr << source << "中" << spec.name << "的值无效: " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool loadConfigFile(const std::string& path, RuntimeConfig& config) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "无法读取配置文件: " << path << std::endl;
+        return false;
+    }
+    json root = json::parse(file, nullptr, false);
+    if (root.is_discarded() || !root.is_object()) {
+        std::cerr << "配置文件不是有效的JSON对象: " << path << std::endl;
+        return false;
+    }
+
+    std::string source = "配置文件" + path;
+    for (const auto& item : root.items()) {
+        const OptionSpec* spec = findOption(item.key());
+        if (spec == nullptr) {
+            std::cerr << source << "中有未知的配置项: " << item.key() << std::endl;
+            return false;
+        }
+        const json& value = item.value();
+        std::string text = value.is_string() ? value.get<std::string>() : value.dump();
+        if (!applyOption(*spec, config, text, source)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cout << "用法: " << program << " [--config 文件] [--参数 值]...\n"
+              << "优先级：命令行参数 > 环境变量 > 配置文件 > 默认值\n\n"
+              << "  --config 文件                JSON配置文件，键与参数同名（环境变量QMS_CONFIG）\n";
+    for (const auto& spec : optionSpecs()) {
+        // “值”在终端中占两列，按显示宽度对齐说明
+        std::string flag = std::string("--") + spec.name + (spec.isFlag ? "" : " 值");
+        size_t width = 2 + std::strlen(spec.name) + (spec.isFlag ? 0 : 3);
+        std::cout << "  " << flag;
+        for (size_t i = width; i < 28; ++i) {
+            std::cout << ' ';
+        }
+        std::cout << " " << spec.help << "（" << envName(spec.name) << "）\n";
+    }
+    std::cout << std::flush;
+}
+
+} // namespace
+
+ConfigStatus loadRuntimeConfig(int argc, char* argv[], RuntimeConfig& config) {
+    // 先把命令行拆成名字和值，配置文件路径需要在应用其他参数之前确定
+    std::vector<std::pair<std::string, std::string>> arguments;
+    std::string configPath;
+    if (const char* path = std::getenv("QMS_CONFIG")) {
+        configPath = path;
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return ConfigStatus::Help;
+        }
+        if (arg.compare(0, 2, "--") != 0) {
+            std::cerr << "无法识别的参数: " << arg << std::endl;
+            return ConfigStatus::Invalid;
+        }
+
+        std::string name = arg.substr(2);
+        std::string value;
+        bool hasValue = false;
+        size_t equals = name.find('=');
+        if (equals != std::string::npos) {
+            value = name.substr(equals + 1);
+            name.resize(equals);
+            hasValue = true;
+        }
+
+        const OptionSpec* spec = findOption(name);
+        if (spec == nullptr && name != "config") {
+            std::cerr << "未知的参数: --" << name << "，使用--help查看可用参数" << std::endl;
+            return ConfigStatus::Invalid;
+        }
+        if (!hasValue) {
+            bool nextIsValue = i + 1 < argc && std::string(argv[i + 1]).compare(0, 2, "--") != 0;
+            if (spec != nullptr && spec->isFlag && !nextIsValue) {
+                value = "1";
+            } else if (nextIsValue) {
+                value = argv[++i];
+            } else {
+                std::cerr << "参数--" << name << "缺少值" << std::endl;
+                return ConfigStatus::Invalid;
+            }
+        }
+
+        if (name == "config") {
+            configPath = value;
+        } else {
+            arguments.emplace_back(name, value);
+        }
+    }
+
+    if (!configPath.empty() && !loadConfigFile(configPath, config)) {
+        return ConfigStatus::Invalid;
+    }
+
+    for (const auto& spec : optionSpecs()) {
+        std::string env = envName(spec.name);
+        const char* value = std::getenv(env.c_str());
+        if (value != nullptr && *value != '\0' && !applyOption(spec, config, value, "环境变量" + env)) {
+            return ConfigStatus::Invalid;
+        }
+    }
+
+    for (const auto& argument : arguments) {
+        if (!applyOption(*findOption(argument.first), config, argument.second, "命令行参数")) {
+            return ConfigStatus::Invalid;
+        }
+    }
+    return ConfigStatus::Run;
+}
+
+} // namespace QualityManagement
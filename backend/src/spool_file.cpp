@@ -0,0 +1,87 @@
+#include "../include/spool_file.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace QualityManagement {
+
+std::unique_ptr<SpoolFile> SpoolFile::create(const std::string& directory) {
+    int fd = open(directory.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0 && (errno == EOPNOTSUPP || errno == EISDIR || errno == EINVAL)) {
+        // 文件系统不支持O_TMPFILE，退化为创建后立即删除名字
+        std::string path = directory + "/qms-body-XXXXXX";
+        fd = mkostemp(path.data(), O_CLOEXEC);
+        if (fd >= 0) {
+            unlink(path.c_str());
+        }
+    }
+    if (fd < 0) {
+        std::cerr << "创建请求体临时文件失败: " << directory << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    return std::unique_ptr<SpoolFile>(new SpoolFile(fd));
+}
+
+std::unique_ptr<SpoolFile> SpoolFile::openReadOnly(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno != ENOENT) {
+            std::cerr << "打开文件失败: " << path << ": " << std::strerror(errno) << std::endl;
+        }
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        std::cerr << "不是普通文件: " << path << std::endl;
+        close(fd);
+        return nullptr;
+    }
+    std::unique_ptr<SpoolFile> file(new SpoolFile(fd));
+    file->size_ = static_cast<size_t>(info.st_size);
+    return file;
+}
+
+SpoolFile::~SpoolFile() {
+    if (mapping_ != nullptr) {
+        munmap(mapping_, size_);
+    }
+    close(fd_);
+}
+
+bool SpoolFile::append(const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd_, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "写入请求体临时文件失败: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+        size_ += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+std::string_view SpoolFile::map() {
+    if (mapping_ == nullptr && size_ > 0) {
+        void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "映射文件失败: " << std::strerror(errno) << std::endl;
+            return std::string_view();
+        }
+        // 解析器从头到尾顺序读取一遍
+        madvise(mapping, size_, MADV_SEQUENTIAL);
+        mapping_ = mapping;
+    }
+    return std::string_view(static_cast<const char*>(mapping_), mapping_ != nullptr ? size_ : 0);
+}
+
+} // namespace QualityManagement
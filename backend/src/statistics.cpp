@@ -10,46 +10,53 @@
 namespace QualityManagement {
 
 // 生成模拟数据
-std::vector<std::vector<double>> Statistics::generateSampleData(int groups, int samplesPerGroup, double mean, double stddev) {
-    std::vector<std::vector<double>> result(groups);
+GroupedData Statistics::generateSampleData(int groups, int samplesPerGroup, double mean, double stddev) {
+    GroupedData result;
     std::random_device rd;
     std::mt19937 gen(rd());
     std::normal_distribution<double> dist(mean, stddev);
 
     for (int i = 0; i < groups; ++i) {
-        result[i].resize(samplesPerGroup);
         for (int j = 0; j < samplesPerGroup; ++j) {
             // 添加一些随机波动，使数据更真实
             double randomFactor = (i % 5 == 0) ? 1.2 : 1.0; // 每5组增加一些异常
-            result[i][j] = dist(gen) * randomFactor;
+            result.appendValue(dist(gen) * randomFactor);
         }
+        result.closeGroup();
     }
     
     return result;
 }
 
 // 设置数据
-void Statistics::setData(const std::vector<std::vector<double>>& data) {
-    data_ = data;
-    
-    // 扁平化数据用于整体分析
-    flatData_.clear();
-    for (const auto& group : data) {
-        flatData_.insert(flatData_.end(), group.begin(), group.end());
-    }
+void Statistics::setData(GroupedData data) {
+    data_ = std::move(data);
     
     // 计算组均值和极差
     groupMeans_.clear();
     groupRanges_.clear();
-    for (const auto& group : data) {
-        if (!group.empty()) {
-            double groupMean = std::accumulate(group.begin(), group.end(), 0.0) / group.size();
-            auto minmax = std::minmax_element(group.begin(), group.end());
-            double groupRange = *minmax.second - *minmax.first;
-            
-            groupMeans_.push_back(groupMean);
-            groupRanges_.push_back(groupRange);
-        }
+    groupMeans_.reserve(data_.groupCount());
+    groupRanges_.reserve(data_.groupCount());
+    for (size_t i = 0; i < data_.groupCount(); ++i) {
+        SampleSpan group = data_.group(i);
+        double groupMean = std::accumulate(group.begin(), group.end(), 0.0) / group.size();
+        auto minmax = std::minmax_element(group.begin(), group.end());
+        double groupRange = *minmax.second - *minmax.first;
+        
+        groupMeans_.push_back(groupMean);
+        groupRanges_.push_back(groupRange);
+    }
+}
+
+void Statistics::appendData(const GroupedData& groups) {
+    for (size_t i = 0; i < groups.groupCount(); ++i) {
+        SampleSpan group = groups.group(i);
+        data_.appendGroup(group);
+        
+        double groupMean = std::accumulate(group.begin(), group.end(), 0.0) / group.size();
+        auto minmax = std::minmax_element(group.begin(), group.end());
+        groupMeans_.push_back(groupMean);
+        groupRanges_.push_back(*minmax.second - *minmax.first);
     }
 }
 
@@ -57,32 +64,32 @@ void Statistics::setData(const std::vector<std::vector<double>>& data) {
 DescriptiveStats Statistics::calculateOverallStats() {
     DescriptiveStats stats;
     
-    if (flatData_.empty()) {
+    if (data_.values().empty()) {
         return stats;
     }
     
     // 计算均值
-    stats.mean = calculateMean(flatData_);
+    stats.mean = calculateMean(data_.values());
     
     // 计算中位数
-    stats.median = calculateMedian(flatData_);
+    stats.median = calculateMedian(data_.values());
     
     // 计算方差和标准差
-    stats.variance = calculateVariance(flatData_, stats.mean);
+    stats.variance = calculateVariance(data_.values(), stats.mean);
     stats.standardDeviation = std::sqrt(stats.variance);
     
     // 计算最小值和最大值
-    auto minmax = std::minmax_element(flatData_.begin(), flatData_.end());
+    auto minmax = std::minmax_element(data_.values().begin(), data_.values().end());
     stats.minimum = *minmax.first;
     stats.maximum = *minmax.second;
     stats.range = stats.maximum - stats.minimum;
     
     // 计算样本大小
-    stats.sampleSize = flatData_.size();
+    stats.sampleSize = data_.values().size();
     
     // 计算偏度和峰度
-    stats.skewness = calculateSkewness(flatData_, stats.mean, stats.standardDeviation);
-    stats.kurtosis = calculateKurtosis(flatData_, stats.mean, stats.standardDeviation);
+    stats.skewness = calculateSkewness(data_.values(), stats.mean, stats.standardDeviation);
+    stats.kurtosis = calculateKurtosis(data_.values(), stats.mean, stats.standardDeviation);
     
     return stats;
 }
@@ -95,35 +102,34 @@ std::vector<DescriptiveStats> Statistics::calculateGroupStats() {
         return result;
     }
     
-    for (const auto& group : data_) {
-        if (!group.empty()) {
-            DescriptiveStats stats;
-            
-            // 计算均值
-            stats.mean = calculateMean(group);
-            
-            // 计算中位数
-            stats.median = calculateMedian(group);
-            
-            // 计算方差和标准差
-            stats.variance = calculateVariance(group, stats.mean);
-            stats.standardDeviation = std::sqrt(stats.variance);
-            
-            // 计算最小值和最大值
-            auto minmax = std::minmax_element(group.begin(), group.end());
-            stats.minimum = *minmax.first;
-            stats.maximum = *minmax.second;
-            stats.range = stats.maximum - stats.minimum;
-            
-            // 计算样本大小
-            stats.sampleSize = group.size();
-            
-            // 计算偏度和峰度
-            stats.skewness = calculateSkewness(group, stats.mean, stats.standardDeviation);
-            stats.kurtosis = calculateKurtosis(group, stats.mean, stats.standardDeviation);
-            
-            result.push_back(stats);
-        }
+    for (size_t i = 0; i < data_.groupCount(); ++i) {
+        SampleSpan group = data_.group(i);
+        DescriptiveStats stats;
+        
+        // 计算均值
+        stats.mean = calculateMean(group);
+        
+        // 计算中位数
+        stats.median = calculateMedian(group);
+        
+        // 计算方差和标准差
+        stats.variance = calculateVariance(group, stats.mean);
+        stats.standardDeviation = std::sqrt(stats.variance);
+        
+        // 计算最小值和最大值
+        auto minmax = std::minmax_element(group.begin(), group.end());
+        stats.minimum = *minmax.first;
+        stats.maximum = *minmax.second;
+        stats.range = stats.maximum - stats.minimum;
+        
+        // 计算样本大小
+        stats.sampleSize = group.size();
+        
+        // 计算偏度和峰度
+        stats.skewness = calculateSkewness(group, stats.mean, stats.standardDeviation);
+        stats.kurtosis = calculateKurtosis(group, stats.mean, stats.standardDeviation);
+        
+        result.push_back(stats);
     }
     
     return result;
@@ -190,7 +196,7 @@ NormalityTest Statistics::testNormality() {
     NormalityTest result;
     result.testMethod = "Shapiro-Wilk";
     
-    auto [statistic, pValue] = shapiroWilkTest(flatData_);
+    auto [statistic, pValue] = shapiroWilkTest(data_.values());
     result.statistic = statistic;
     result.pValue = pValue;
     result.isNormal = pValue >= 0.05; // 通常p值大于0.05认为符合正态分布
@@ -210,19 +216,19 @@ MeanTest Statistics::testMean(double expectedMean, double alpha) {
     result.expectedMean = expectedMean;
     result.alpha = alpha;
     
-    if (flatData_.empty()) {
+    if (data_.values().empty()) {
         result.testResult = false;
         result.conclusion = "数据为空，无法进行检验";
         return result;
     }
     
     // 计算均值和标准差
-    result.sampleMean = calculateMean(flatData_);
-    double variance = calculateVariance(flatData_, result.sampleMean);
+    result.sampleMean = calculateMean(data_.values());
+    double variance = calculateVariance(data_.values(), result.sampleMean);
     double stdDev = std::sqrt(variance);
     
     // 计算t统计量
-    result.tStatistic = (result.sampleMean - expectedMean) / (stdDev / std::sqrt(flatData_.size()));
+    result.tStatistic = (result.sampleMean - expectedMean) / (stdDev / std::sqrt(data_.values().size()));
     
     // 简化版的双侧t检验
     // 对于大样本，可以近似为正态分布
@@ -274,17 +280,18 @@ CapabilityIndices Statistics::calculateCapabilityIndices(double lsl, double usl)
     
     // 新增字段计算 - Taguchi过程能力指数(Cpm)
     double sumSquaredDiff = 0.0;
-    for (const auto& value : flatData_) {
+    for (const auto& value : data_.values()) {
         sumSquaredDiff += std::pow(value - target, 2);
     }
-    double tau = std::sqrt(sumSquaredDiff / flatData_.size());
+    double tau = std::sqrt(sumSquaredDiff / data_.values().size());
     indices.cpm = (usl - lsl) / (6 * tau);
     
     // 过程内部方差指标 - 基于子组内差异
     double avgGroupStdDev = 0.0;
     int validGroups = 0;
     
-    for (const auto& group : data_) {
+    for (size_t i = 0; i < data_.groupCount(); ++i) {
+        SampleSpan group = data_.group(i);
         if (group.size() > 1) {
             double groupMean = calculateMean(group);
             double groupVar = calculateVariance(group, groupMean);
@@ -319,14 +326,14 @@ CapabilityIndices Statistics::calculateCapabilityIndices(double lsl, double usl)
     
     // 观察到的PPM通过直接计数计算
     int outOfSpecCount = 0;
-    for (const auto& value : flatData_) {
+    for (const auto& value : data_.values()) {
         if (value < lsl || value > usl) {
             outOfSpecCount++;
         }
     }
     
-    if (!flatData_.empty()) {
-        indices.ppm.observed = 1000000.0 * outOfSpecCount / flatData_.size();
+    if (!data_.values().empty()) {
+        indices.ppm.observed = 1000000.0 * outOfSpecCount / data_.values().size();
     } else {
         indices.ppm.observed = 0.0;
     }
@@ -335,21 +342,22 @@ CapabilityIndices Statistics::calculateCapabilityIndices(double lsl, double usl)
 }
 
 // 生成控制图数据
-ControlChartData Statistics::generateControlChartData() {
+ControlChartData Statistics::generateControlChartData(size_t firstGroup) {
     ControlChartData chartData;
     
-    if (data_.empty() || data_[0].empty()) {
+    if (data_.empty()) {
         return chartData;
     }
     
-    chartData.means = groupMeans_;
-    chartData.ranges = groupRanges_;
+    firstGroup = std::min(firstGroup, groupMeans_.size());
+    chartData.means.assign(groupMeans_.begin() + firstGroup, groupMeans_.end());
+    chartData.ranges.assign(groupRanges_.begin() + firstGroup, groupRanges_.end());
     
     // 计算均值图的控制限
     double meanOfMeans = calculateMean(groupMeans_);
     double meanOfRanges = calculateMean(groupRanges_);
     
-    int n = data_[0].size(); // 子组大小
+    int n = data_.group(0).size(); // 子组大小
     
     // 控制图常数（根据子组大小确定）
     double A2 = getControlChartConstantA2(n);
@@ -365,17 +373,21 @@ ControlChartData Statistics::generateControlChartData() {
     chartData.uclRange = D4 * meanOfRanges;
     chartData.lclRange = D3 * meanOfRanges;
     
-    // 判断过程是否受控
-    chartData.isControlled = true;
-    for (size_t i = 0; i < chartData.means.size(); ++i) {
-        if (chartData.means[i] > chartData.uclMean || 
-            chartData.means[i] < chartData.lclMean ||
-            chartData.ranges[i] > chartData.uclRange ||
-            chartData.ranges[i] < chartData.lclRange) {
-            chartData.isControlled = false;
-            break;
+    // 判断过程是否受控，记录超出控制限的子组
+    for (size_t i = 0; i < groupMeans_.size(); ++i) {
+        bool meanOut = groupMeans_[i] > chartData.uclMean || groupMeans_[i] < chartData.lclMean;
+        bool rangeOut = groupRanges_[i] > chartData.uclRange || groupRanges_[i] < chartData.lclRange;
+        if (meanOut) {
+            chartData.meanOutOfControlPoints.push_back(i);
+        }
+        if (rangeOut) {
+            chartData.rangeOutOfControlPoints.push_back(i);
+        }
+        if (meanOut || rangeOut) {
+            chartData.outOfControlPoints.push_back(i);
         }
     }
+    chartData.isControlled = chartData.outOfControlPoints.empty();
     
     return chartData;
 }
@@ -416,14 +428,15 @@ ProcessAssessment Statistics::assessProcess(double lsl, double usl) {
 }
 
 // 辅助函数实现...
-double Statistics::calculateMean(const std::vector<double>& data) {
+double Statistics::calculateMean(SampleSpan data) {
     if (data.empty()) return 0.0;
     return std::accumulate(data.begin(), data.end(), 0.0) / data.size();
 }
 
-double Statistics::calculateMedian(std::vector<double> data) {
-    if (data.empty()) return 0.0;
+double Statistics::calculateMedian(SampleSpan samples) {
+    if (samples.empty()) return 0.0;
     
+    std::vector<double> data(samples.begin(), samples.end());
     std::sort(data.begin(), data.end());
     size_t n = data.size();
     
@@ -434,7 +447,7 @@ double Statistics::calculateMedian(std::vector<double> data) {
     }
 }
 
-double Statistics::calculateVariance(const std::vector<double>& data, double mean) {
+double Statistics::calculateVariance(SampleSpan data, double mean) {
     if (data.empty()) return 0.0;
     
     double sumSquaredDiff = 0.0;
@@ -445,7 +458,7 @@ double Statistics::calculateVariance(const std::vector<double>& data, double mea
     return sumSquaredDiff / data.size();
 }
 
-double Statistics::calculateSkewness(const std::vector<double>& data, double mean, double stdDev) {
+double Statistics::calculateSkewness(SampleSpan data, double mean, double stdDev) {
     if (data.empty() || stdDev == 0) return 0.0;
     
     double sum = 0.0;
@@ -456,7 +469,7 @@ double Statistics::calculateSkewness(const std::vector<double>& data, double mea
     return sum / data.size();
 }
 
-double Statistics::calculateKurtosis(const std::vector<double>& data, double mean, double stdDev) {
+double Statistics::calculateKurtosis(SampleSpan data, double mean, double stdDev) {
     if (data.empty() || stdDev == 0) return 0.0;
     
     double sum = 0.0;
@@ -517,13 +530,13 @@ double Statistics::getControlChartConstantD4(int sampleSize) {
 
 std::vector<double> Statistics::generateHistogram(int bins) {
     // 简化实现，返回直方图的区间中心值
-    if (flatData_.empty() || bins <= 0) {
+    if (data_.values().empty() || bins <= 0) {
         return {};
     }
     
     // 找到数据的范围
-    double minVal = *std::min_element(flatData_.begin(), flatData_.end());
-    double maxVal = *std::max_element(flatData_.begin(), flatData_.end());
+    double minVal = *std::min_element(data_.values().begin(), data_.values().end());
+    double maxVal = *std::max_element(data_.values().begin(), data_.values().end());
     double range = maxVal - minVal;
     
     // 避免除以零的情况
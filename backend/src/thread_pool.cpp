@@ -0,0 +1,112 @@
+#include "../include/thread_pool.h"
+#include <iostream>
+
+namespace QualityManagement {
+
+ThreadPool::ThreadPool(size_t threadCount, size_t queueCapacity)
+    : queueCapacity_(queueCapacity) {
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    workers_.reserve(threadCount);
+    liveWorkers_ = threadCount;
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+bool ThreadPool::trySubmit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || tasks_.size() >= queueCapacity_) {
+            return false;
+        }
+        tasks_.push_back(std::move(task));
+    }
+    condition_.notify_one();
+    return true;
+}
+
+size_t ThreadPool::beginShutdown(bool discardQueued) {
+    std::deque<Task> discarded;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        if (discardQueued) {
+            discarded.swap(tasks_);
+        }
+    }
+    condition_.notify_all();
+    // 在锁外销毁被丢弃的任务，它们捕获的准入凭据等资源在析构时释放
+    size_t count = discarded.size();
+    discarded.clear();
+    return count;
+}
+
+size_t ThreadPool::shutdown(bool discardQueued) {
+    size_t count = beginShutdown(discardQueued);
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+    return count;
+}
+
+bool ThreadPool::shutdownFor(std::chrono::milliseconds timeout, size_t& discarded) {
+    discarded = beginShutdown(true);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!exited_.wait_for(lock, timeout, [this] { return liveWorkers_ == 0; })) {
+            // 仍有任务在执行：不再等待，分离工作线程
+            for (auto& worker : workers_) {
+                worker.detach();
+            }
+            workers_.clear();
+            return false;
+        }
+    }
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    return true;
+}
+
+size_t ThreadPool::queueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                // 已关闭且队列为空
+                --liveWorkers_;
+                exited_.notify_all();
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "计算任务异常: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "计算任务发生未知异常" << std::endl;
+        }
+    }
+}
+
+} // namespace QualityManagement
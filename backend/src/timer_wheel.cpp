@@ -0,0 +1,107 @@
+#include "../include/timer_wheel.h"
+#include <algorithm>
+#include <chrono>
+
+namespace QualityManagement {
+
+void TimerNode::cancel() {
+    if (wheel == nullptr) {
+        return;
+    }
+    prev->next = next;
+    next->prev = prev;
+    --wheel->count_;
+    prev = nullptr;
+    next = nullptr;
+    wheel = nullptr;
+}
+
+TimerWheel::TimerWheel(uint64_t tickMs)
+    : tickMs_(std::max<uint64_t>(1, tickMs)), startMs_(nowMs()) {
+}
+
+uint64_t TimerWheel::nowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void TimerWheel::schedule(TimerNode& node, uint64_t delayMs) {
+    node.cancel();
+
+    // 空轮不推进刻度，重新启用前先对齐到当前时间
+    if (count_ == 0) {
+        currentTick_ = std::max(currentTick_, (nowMs() - startMs_) / tickMs_);
+    }
+
+    // 向上取整到刻度，至少一个刻度后到期；超出最高层范围的延迟被截断
+    const uint64_t maxTicks = (uint64_t(1) << (kLevels * kSlotBits)) - kSlots;
+    uint64_t ticks = std::min(std::max<uint64_t>(1, (delayMs + tickMs_ - 1) / tickMs_), maxTicks);
+    node.expiry = currentTick_ + ticks;
+    place(node);
+    ++count_;
+}
+
+void TimerWheel::place(TimerNode& node) {
+    // 按到期刻度与当前刻度最高的不同位段选择层：同一段内的放在第0层，
+    // 其余放在对应层，该层槽位在到期前被下放时再细分
+    int level = 0;
+    while (level < kLevels - 1 &&
+           (node.expiry >> ((level + 1) * kSlotBits)) != (currentTick_ >> ((level + 1) * kSlotBits))) {
+        ++level;
+    }
+    size_t index = (node.expiry >> (level * kSlotBits)) & (kSlots - 1);
+
+    TimerNode& head = slots_[level][index].head;
+    node.prev = head.prev;
+    node.next = &head;
+    head.prev->next = &node;
+    head.prev = &node;
+    node.wheel = this;
+}
+
+void TimerWheel::cascade(int level) {
+    size_t index = (currentTick_ >> (level * kSlotBits)) & (kSlots - 1);
+    TimerNode& head = slots_[level][index].head;
+
+    // 整条链表摘下后逐个重新放置，它们会落到更低的层
+    TimerNode* node = head.next;
+    head.prev = head.next = &head;
+    while (node != &head) {
+        TimerNode* next = node->next;
+        place(*node);
+        node = next;
+    }
+}
+
+void TimerWheel::advance(const Callback& callback) {
+    uint64_t targetTick = (nowMs() - startMs_) / tickMs_;
+    if (count_ == 0) {
+        currentTick_ = std::max(currentTick_, targetTick);
+        return;
+    }
+
+    while (currentTick_ < targetTick) {
+        ++currentTick_;
+
+        // 低层转完一圈时，把高层对应槽位下放
+        for (int level = 1; level < kLevels; ++level) {
+            if ((currentTick_ & ((uint64_t(1) << (level * kSlotBits)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        TimerNode& head = slots_[0][currentTick_ & (kSlots - 1)].head;
+        while (head.next != &head) {
+            TimerNode& node = *head.next;
+            node.cancel();
+            callback(node);
+        }
+
+        if (count_ == 0) {
+            currentTick_ = targetTick;
+        }
+    }
+}
+
+} // namespace QualityManagement
@@ -0,0 +1,471 @@
+#include "../include/uring_reactor.h"
+#include <algorithm>
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace QualityManagement {
+
+UringReactor::~UringReactor() {
+    if (wakeFd_ >= 0) {
+        close(wakeFd_);
+    }
+}
+
+bool UringReactor::init() {
+    if (!ring_.init(options_.uringEntries)) {
+        std::cerr << "创建io_uring实例失败: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // 固定缓冲一次性分配并注册，内核在整个生命周期内保持这些页的映射；
+    // 数量配置为0时不注册，所有接收直接读入连接的接收缓冲
+    const size_t chunk = options_.readChunkSize;
+    const int count = options_.uringFixedBuffers;
+    if (count > 0) {
+        fixedBuffers_.reset(new char[chunk * count]);
+        std::vector<iovec> buffers(count);
+        for (int i = 0; i < count; ++i) {
+            buffers[i].iov_base = fixedBuffers_.get() + i * chunk;
+            buffers[i].iov_len = chunk;
+        }
+        if (ring_.registerBuffers(buffers.data(), static_cast<unsigned>(count))) {
+            for (int i = count - 1; i >= 0; --i) {
+                freeFixedBuffers_.push_back(i);
+            }
+        } else {
+            // 通常是RLIMIT_MEMLOCK过小，退化为普通recv
+            std::cerr << "注册io_uring固定缓冲失败: " << std::strerror(errno) << std::endl;
+            fixedBuffers_.reset();
+        }
+    }
+
+    // 阻塞模式的eventfd：异步读取由io_uring等待，而不是立即返回EAGAIN
+    wakeFd_ = eventfd(0, EFD_CLOEXEC);
+    if (wakeFd_ < 0) {
+        std::cerr << "创建eventfd失败: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    running_.store(true, std::memory_order_release);
+    return true;
+}
+
+void UringReactor::run() {
+    armWakeup();
+    acceptAddresses_.resize(listenFds_.size());
+    for (int listenFd : listenFds_) {
+        armAccept(listenFd);
+    }
+
+    while (running_.load(std::memory_order_acquire)) {
+        // 一次系统调用同时提交新操作并等待完成事件
+        if (ring_.submitAndWait(1) < 0 && errno != EBUSY) {
+            std::cerr << "io_uring_enter失败: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        io_uring_cqe cqe;
+        while (ring_.popCqe(cqe)) {
+            handleCqe(cqe);
+        }
+
+        expireTimers();
+        armTimer();
+        if (draining_.load(std::memory_order_acquire) && drainComplete()) {
+            // 退出前收回操作时不再重新提交唤醒读取
+            running_.store(false, std::memory_order_release);
+            break;
+        }
+    }
+
+    drain();
+    finished_.store(true, std::memory_order_release);
+}
+
+void UringReactor::wakeup() {
+    uint64_t one = 1;
+    if (write(wakeFd_, &one, sizeof(one)) < 0) {
+        // eventfd计数已满时同样能唤醒事件循环，忽略错误
+    }
+}
+
+io_uring_sqe* UringReactor::prepareSqe(int fd, Op op) {
+    io_uring_sqe* sqe = ring_.getSqe();
+    if (sqe == nullptr) {
+        std::cerr << "io_uring提交队列已满" << std::endl;
+        return nullptr;
+    }
+    sqe->fd = fd;
+    sqe->user_data = (static_cast<uint64_t>(fd) << 8) | op;
+    ++pendingOps_;
+    return sqe;
+}
+
+void UringReactor::armAccept(int listenFd) {
+    io_uring_sqe* sqe = prepareSqe(listenFd, OpAccept);
+    if (sqe == nullptr) {
+        return;
+    }
+    AcceptAddress& slot = acceptAddress(listenFd);
+    slot.length = sizeof(slot.address);
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->addr = reinterpret_cast<uint64_t>(&slot.address);
+    sqe->addr2 = reinterpret_cast<uint64_t>(&slot.length);
+    sqe->accept_flags = SOCK_CLOEXEC;
+    ++acceptsPending_;
+}
+
+void UringReactor::armWakeup() {
+    io_uring_sqe* sqe = prepareSqe(wakeFd_, OpWakeup);
+    if (sqe == nullptr) {
+        return;
+    }
+    sqe->opcode = IORING_OP_READ;
+    sqe->addr = reinterpret_cast<uint64_t>(&wakeValue_);
+    sqe->len = sizeof(wakeValue_);
+}
+
+void UringReactor::armTimer() {
+    // 有连接在计时时保持一个刻度长的超时操作，让事件循环按刻度醒来推进时间轮
+    if (timerPending_ || timerFailed_ || timers_.empty()) {
+        return;
+    }
+    io_uring_sqe* sqe = prepareSqe(-1, OpTimer);
+    if (sqe == nullptr) {
+        return;
+    }
+    timerSpec_.tv_sec = static_cast<int64_t>(timers_.tickMs() / 1000);
+    timerSpec_.tv_nsec = static_cast<long long>(timers_.tickMs() % 1000) * 1000000;
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->addr = reinterpret_cast<uint64_t>(&timerSpec_);
+    // len是timespec的个数，内核要求为1；off是提前结束超时所需的完成事件数，
+    // 0表示纯超时，只在刻度到达时以-ETIME完成，其他操作的完成事件不会提前触发它
+    sqe->len = 1;
+    sqe->off = 0;
+    timerPending_ = true;
+}
+
+void UringReactor::armRecv(Connection& conn) {
+    // 请求计算期间缓冲被工作线程引用，不能写入或移动，完成后再继续接收
+    if (conn.recvPending || conn.closing || conn.busy || conn.closeAfterWrite || conn.peerClosed) {
+        return;
+    }
+
+    io_uring_sqe* sqe = prepareSqe(conn.fd, OpRecv);
+    if (sqe == nullptr) {
+        closeConnection(conn.fd);
+        return;
+    }
+
+    if (!freeFixedBuffers_.empty()) {
+        conn.fixedBuffer = freeFixedBuffers_.back();
+        freeFixedBuffers_.pop_back();
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->addr = reinterpret_cast<uint64_t>(fixedBuffers_.get() + conn.fixedBuffer * options_.readChunkSize);
+        sqe->len = static_cast<uint32_t>(options_.readChunkSize);
+        sqe->buf_index = static_cast<uint16_t>(conn.fixedBuffer);
+    } else {
+        // 固定缓冲用尽（如大量空闲的长连接）时直接读入接收缓冲尾部
+        char* target = conn.input->prepare(options_.readChunkSize);
+        sqe->opcode = IORING_OP_RECV;
+        sqe->addr = reinterpret_cast<uint64_t>(target);
+        sqe->len = static_cast<uint32_t>(conn.input->writable());
+    }
+    conn.recvPending = true;
+}
+
+void UringReactor::flushOutput(Connection& conn) {
+    // 同一连接同时只有一个发送操作，保证数据按顺序写出
+    if (conn.sendPending || conn.closing || conn.output.empty()) {
+        return;
+    }
+
+    io_uring_sqe* sqe = prepareSqe(conn.fd, OpSend);
+    if (sqe == nullptr) {
+        closeConnection(conn.fd);
+        return;
+    }
+
+    size_t maxIovecs = sizeof(conn.sendIovecs) / sizeof(conn.sendIovecs[0]);
+    conn.sendMessage = msghdr{};
+    conn.sendMessage.msg_iov = conn.sendIovecs;
+    conn.sendMessage.msg_iovlen = conn.output.prepareIovecs(conn.sendIovecs, maxIovecs);
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->addr = reinterpret_cast<uint64_t>(&conn.sendMessage);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    conn.sendPending = true;
+}
+
+void UringReactor::continueConnection(Connection& conn) {
+    flushOutput(conn);
+    if (conn.closing) {
+        return;
+    }
+
+    // 响应全部发出且没有进行中的请求时，按需关闭连接
+    if (!conn.sendPending && !conn.busy && (conn.closeAfterWrite || conn.peerClosed)) {
+        closeConnection(conn.fd);
+        return;
+    }
+    armRecv(conn);
+}
+
+void UringReactor::resumeConnection(Connection& conn) {
+    if (conn.closing) {
+        return;
+    }
+    // 计算期间不提交接收，此时不会有接收操作在写入缓冲；
+    // 万一仍有未完成的接收，缓冲中的请求留到接收返回后再处理
+    if (!conn.recvPending) {
+        processRequests(conn);
+    }
+    continueConnection(conn);
+}
+
+void UringReactor::flushConnection(Connection& conn) {
+    if (!conn.closing) {
+        continueConnection(conn);
+    }
+}
+
+void UringReactor::handleCqe(const io_uring_cqe& cqe) {
+    --pendingOps_;
+    Op op = static_cast<Op>(cqe.user_data & 0xff);
+    int fd = static_cast<int>(cqe.user_data >> 8);
+
+    switch (op) {
+    case OpWakeup:
+        handleCompletions();
+        if (running_.load(std::memory_order_acquire)) {
+            armWakeup();
+        }
+        return;
+    case OpAccept:
+        --acceptsPending_;
+        handleAccept(fd, cqe.res);
+        if (running_.load(std::memory_order_acquire) && !draining_.load(std::memory_order_acquire)) {
+            armAccept(fd);
+        }
+        return;
+    case OpTimer:
+        timerPending_ = false;
+        // 刻度到达返回-ETIME，退出时被移除返回-ECANCELED；
+        // 其他错误重新提交也会立即失败，不再提交，避免事件循环空转
+        if (cqe.res != -ETIME && cqe.res != -ECANCELED) {
+            std::cerr << "io_uring超时操作失败，连接期限不再生效: " << std::strerror(-cqe.res) << std::endl;
+            timerFailed_ = true;
+        }
+        return;
+    case OpCancel:
+        return;
+    default:
+        break;
+    }
+
+    // 连接在所有操作完成前不会释放，描述符也不会被复用
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) {
+        return;
+    }
+    if (op == OpRecv) {
+        handleRecv(*it->second, cqe.res);
+    } else {
+        handleSend(*it->second, cqe.res);
+    }
+}
+
+UringReactor::AcceptAddress& UringReactor::acceptAddress(int listenFd) {
+    size_t index = std::find(listenFds_.begin(), listenFds_.end(), listenFd) - listenFds_.begin();
+    return acceptAddresses_[index];
+}
+
+void UringReactor::handleAccept(int listenFd, int result) {
+    if (result < 0) {
+        // 停止期间监听套接字被关闭，accept返回EINVAL
+        if (result != -EAGAIN && result != -EINTR && result != -ECONNABORTED && result != -ECANCELED &&
+            !draining_.load(std::memory_order_acquire)) {
+            std::cerr << "接受客户端连接失败: " << std::strerror(-result) << std::endl;
+        }
+        return;
+    }
+
+    int fd = result;
+    if (!running_.load(std::memory_order_acquire)) {
+        close(fd);
+        return;
+    }
+
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    const AcceptAddress& slot = acceptAddress(listenFd);
+    armRecv(addConnection(fd, reinterpret_cast<const sockaddr*>(&slot.address), slot.length));
+}
+
+void UringReactor::handleRecv(Connection& conn, int result) {
+    conn.recvPending = false;
+    if (conn.fixedBuffer >= 0) {
+        // 从固定缓冲拷入接收缓冲后立即归还，供其他连接的下一次读取使用
+        if (result > 0) {
+            char* target = conn.input->prepare(result);
+            std::memcpy(target, fixedBuffers_.get() + conn.fixedBuffer * options_.readChunkSize, result);
+            conn.input->commit(result);
+        }
+        freeFixedBuffers_.push_back(conn.fixedBuffer);
+        conn.fixedBuffer = -1;
+    } else if (result > 0) {
+        conn.input->commit(result);
+    }
+    if (conn.discardPending) {
+        // 被取消的接收已返回，内核不再引用接收缓冲，此时才能清空
+        conn.discardPending = false;
+        conn.input->consume(conn.input->size());
+    }
+
+    if (conn.closing) {
+        releaseIfIdle(conn);
+        return;
+    }
+    if (result == -EAGAIN || result == -EINTR) {
+        armRecv(conn);
+        return;
+    }
+    if (result == -ECANCELED) {
+        // discardInput取消的接收：连接只等待已入队的响应发完后关闭
+        continueConnection(conn);
+        return;
+    }
+    if (result < 0) {
+        if (result != -ECONNRESET) {
+            std::cerr << "接收数据失败: " << std::strerror(-result) << std::endl;
+        }
+        closeConnection(conn.fd);
+        return;
+    }
+
+    // 对端关闭写方向后，仍然处理并回复已完整到达的请求
+    if (result == 0) {
+        conn.peerClosed = true;
+    }
+    processRequests(conn);
+    continueConnection(conn);
+}
+
+void UringReactor::handleSend(Connection& conn, int result) {
+    conn.sendPending = false;
+    if (conn.closing) {
+        releaseIfIdle(conn);
+        return;
+    }
+    if (result < 0 && result != -EAGAIN && result != -EINTR) {
+        closeConnection(conn.fd);
+        return;
+    }
+
+    // 部分发送时记录进度，下一次从断点继续
+    if (result > 0) {
+        conn.output.advance(static_cast<size_t>(result));
+        reportWriteProgress(conn);
+    }
+    continueConnection(conn);
+}
+
+void UringReactor::closeConnection(int fd) {
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) {
+        return;
+    }
+    Connection& conn = *it->second;
+
+    if (conn.recvPending || conn.sendPending) {
+        // 关闭读写方向使未完成的操作尽快返回，全部返回后再释放连接
+        if (!conn.closing) {
+            conn.closing = true;
+            conn.timer.cancel();
+            shutdown(fd, SHUT_RDWR);
+        }
+        return;
+    }
+
+    close(fd);
+    connections_.erase(it);
+}
+
+void UringReactor::discardInput(Connection& conn) {
+    if (!conn.recvPending) {
+        conn.input->consume(conn.input->size());
+        return;
+    }
+    // 非固定缓冲的接收直接写入接收缓冲尾部，此时清空（缓冲超过保留上限时还会释放内存）
+    // 会让内核写入已释放或被复用的内存；先取消接收，在handleRecv中清空
+    if (conn.discardPending) {
+        return;
+    }
+    conn.discardPending = true;
+    io_uring_sqe* sqe = prepareSqe(conn.fd, OpCancel);
+    if (sqe != nullptr) {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = (static_cast<uint64_t>(conn.fd) << 8) | OpRecv;
+    }
+}
+
+void UringReactor::stopAccepting() {
+    if (acceptsPending_ == 0) {
+        return;
+    }
+    for (int listenFd : listenFds_) {
+        io_uring_sqe* sqe = prepareSqe(listenFd, OpCancel);
+        if (sqe != nullptr) {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = (static_cast<uint64_t>(listenFd) << 8) | OpAccept;
+        }
+    }
+}
+
+void UringReactor::releaseIfIdle(Connection& conn) {
+    if (!conn.recvPending && !conn.sendPending) {
+        closeConnection(conn.fd);
+    }
+}
+
+void UringReactor::drain() {
+    // 退出前收回所有已提交的操作，避免内核在连接和缓冲释放后仍写入
+    std::vector<int> fds;
+    fds.reserve(connections_.size());
+    for (auto& entry : connections_) {
+        fds.push_back(entry.first);
+    }
+    for (int fd : fds) {
+        closeConnection(fd);
+    }
+
+    stopAccepting();
+    if (timerPending_) {
+        io_uring_sqe* sqe = prepareSqe(-1, OpCancel);
+        if (sqe != nullptr) {
+            sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+            sqe->addr = (static_cast<uint64_t>(-1) << 8) | OpTimer;
+        }
+    }
+    wakeup();
+
+    while (pendingOps_ > 0) {
+        if (ring_.submitAndWait(1) < 0 && errno != EBUSY) {
+            std::cerr << "io_uring_enter失败: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        io_uring_cqe cqe;
+        while (ring_.popCqe(cqe)) {
+            handleCqe(cqe);
+        }
+    }
+}
+
+} // namespace QualityManagement
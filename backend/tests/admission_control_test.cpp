@@ -0,0 +1,66 @@
+#include "../include/admission_control.h"
+#include "../include/api_handler.h"
+#include <gtest/gtest.h>
+#include <limits>
+
+namespace QualityManagement {
+namespace {
+
+using json = nlohmann::json;
+
+TEST(AdmissionControlTest, AnalysisCostScalesWithDataset) {
+    uint64_t small = AdmissionController::estimateCost("/all-analysis", 2, 1000);
+    uint64_t large = AdmissionController::estimateCost("/all-analysis", 2, 1000000);
+    EXPECT_GT(large, small);
+    EXPECT_GT(AdmissionController::estimateCost("/all-analysis", 2, 1000),
+              AdmissionController::estimateCost("/mean-test", 2, 1000));
+}
+
+TEST(AdmissionControlTest, ImportCostScalesWithBody) {
+    EXPECT_GT(AdmissionController::estimateCost("/import-data", 80000000, 0),
+              AdmissionController::estimateCost("/import-data", 800, 1000000));
+}
+
+TEST(AdmissionControlTest, GenerateCostUsesRequestedSize) {
+    // 空数据集上请求生成大量数据，代价按要求生成的样本点数计算
+    uint64_t requested = ApiHandler::generatedSampleCount(json{{"groups", 1000000}, {"samplesPerGroup", 100}});
+    EXPECT_EQ(requested, 100000000u);
+    uint64_t cost = AdmissionController::estimateCost("/generate-data", 40, 0, requested);
+    EXPECT_GE(cost, requested);
+
+    // 代价与现有数据集的规模无关
+    EXPECT_EQ(AdmissionController::estimateCost("/generate-data", 40, 50000000, 125),
+              AdmissionController::estimateCost("/generate-data", 40, 0, 125));
+
+    // 已有请求在执行时，超出预算的生成请求被拒绝
+    AdmissionController admission(10 * 1000 * 1000);
+    ASSERT_TRUE(admission.tryAdmit(AdmissionController::estimateCost("/mean-test", 2, 1000)));
+    EXPECT_FALSE(admission.tryAdmit(cost));
+    EXPECT_EQ(admission.shedCount(), 1u);
+}
+
+TEST(AdmissionControlTest, UnknownGenerateSizeDoesNotOverflow) {
+    uint64_t cost = AdmissionController::estimateCost("/generate-data", 1 << 20, 0,
+                                                      std::numeric_limits<uint64_t>::max());
+    EXPECT_GT(cost, uint64_t(1) << 40);
+}
+
+TEST(AdmissionControlTest, GeneratedSampleCount) {
+    EXPECT_EQ(ApiHandler::generatedSampleCount(json::object()), 125u);
+    EXPECT_EQ(ApiHandler::generatedSampleCount(json{{"groups", 10}}), 50u);
+    EXPECT_EQ(ApiHandler::generatedSampleCount(json{{"groups", -3}, {"samplesPerGroup", 5}}), 0u);
+    EXPECT_EQ(ApiHandler::generatedSampleCount(json{{"groups", "many"}}), 0u);
+    EXPECT_EQ(ApiHandler::generatedSampleCount(json::array()), 0u);
+}
+
+TEST(AdmissionControlTest, IdleControllerAlwaysAdmits) {
+    AdmissionController admission(1000);
+    EXPECT_TRUE(admission.tryAdmit(1000000));
+    EXPECT_FALSE(admission.tryAdmit(1));
+    admission.release(1000000);
+    EXPECT_EQ(admission.inFlightCost(), 0u);
+    EXPECT_TRUE(admission.tryAdmit(1));
+}
+
+} // namespace
+} // namespace QualityManagement
@@ -0,0 +1,120 @@
+#include "../include/api_handler.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+
+namespace QualityManagement {
+namespace {
+
+using json = nlohmann::json;
+
+json importJson(ApiHandler& handler, const std::string& body) {
+    return json::parse(handler.importData(body));
+}
+
+TEST(ImportDataTest, ImportsNumericGroups) {
+    ApiHandler handler;
+    json response = importJson(handler, R"({"data":[[1,2.5,3],[4,5],[-6e1]]})");
+    EXPECT_EQ(response, json({{"success", true}, {"message", "数据导入成功"}, {"count", 3}}));
+    EXPECT_EQ(handler.sampleCount(), 6u);
+    EXPECT_TRUE(handler.hasData());
+}
+
+TEST(ImportDataTest, IgnoresNonNumbersAndEmptyGroups) {
+    ApiHandler handler;
+    json response = importJson(handler,
+        R"({"name":"x","data":[[1,"a",null,true,2],[],[{"v":9},[8]],[3]],"extra":[[7]]})");
+    EXPECT_EQ(response["success"], true);
+    EXPECT_EQ(response["count"], 2);
+    EXPECT_EQ(handler.sampleCount(), 3u);
+}
+
+TEST(ImportDataTest, LastDuplicateDataKeyWins) {
+    ApiHandler handler;
+    json response = importJson(handler, R"({"data":[[1,2,3]],"data":[[4],[5]]})");
+    EXPECT_EQ(response["count"], 2);
+    EXPECT_EQ(handler.sampleCount(), 2u);
+}
+
+TEST(ImportDataTest, RejectsMissingOrNonArrayData) {
+    const char* bodies[] = {
+        R"({})",
+        R"({"data":5})",
+        R"({"data":[[1]],"data":"x"})",
+        R"({"nested":{"data":[[1]]}})",
+        R"([[1,2]])",
+    };
+    for (const char* body : bodies) {
+        ApiHandler handler;
+        json response = importJson(handler, body);
+        EXPECT_EQ(response, json({{"success", false}, {"error", "无效的参数格式"}})) << body;
+        EXPECT_FALSE(handler.hasData()) << body;
+    }
+}
+
+TEST(ImportDataTest, ReportsParsePosition) {
+    ApiHandler handler;
+    json response = importJson(handler, R"({"data":[[1,2,]]})");
+    EXPECT_EQ(response["success"], false);
+    EXPECT_EQ(response["error"], "JSON解析错误: 第15字节处语法错误");
+    EXPECT_FALSE(handler.hasData());
+}
+
+TEST(ImportDataTest, FailedImportKeepsPreviousData) {
+    ApiHandler handler;
+    importJson(handler, R"({"data":[[1,2],[3,4]]})");
+    importJson(handler, R"({"data":[[1,)");
+    EXPECT_EQ(handler.sampleCount(), 4u);
+}
+
+TEST(ImportDataTest, AcceptsBinaryFormats) {
+    json body = {{"data", {{1.5, 2.5}, {3.5}}}};
+    for (BodyFormat format : {BodyFormat::Cbor, BodyFormat::MessagePack}) {
+        ApiHandler handler;
+        std::string response = handler.handleRequest("/import-data", encodeValue(body, format), format, format);
+        EXPECT_EQ(decodeBody(response, format),
+                  json({{"success", true}, {"message", "数据导入成功"}, {"count", 2}})) << mediaType(format);
+        EXPECT_EQ(handler.sampleCount(), 3u);
+    }
+}
+
+TEST(ImportDataTest, AppendExtendsDataset) {
+    ApiHandler handler;
+    importJson(handler, R"({"data":[[1,2]]})");
+    json response = json::parse(handler.handleRequest("/append-data", R"({"data":[[3],[4,5]]})"));
+    EXPECT_EQ(response["success"], true);
+    EXPECT_EQ(handler.sampleCount(), 5u);
+
+    json stats = json::parse(handler.handleRequest("/descriptive-stats", "{}"));
+    ASSERT_EQ(stats["success"], true) << stats.dump();
+    EXPECT_EQ(stats.dump().find("\"sampleSize\":5") != std::string::npos, true);
+}
+
+TEST(ImportDataTest, SavedDataLoadsBack) {
+    std::string path = ::testing::TempDir() + "qms_state_test.json";
+    ApiHandler saved;
+    importJson(saved, R"({"data":[[1,2.5,3],[4,5],[-6e1]]})");
+    ASSERT_TRUE(saved.saveData(path));
+
+    ApiHandler loaded;
+    EXPECT_TRUE(loaded.loadData(path));
+    EXPECT_EQ(loaded.sampleCount(), 6u);
+    EXPECT_EQ(loaded.handleRequest("/descriptive-stats", "{}"), saved.handleRequest("/descriptive-stats", "{}"));
+
+    // 损坏的文件不改变已有数据
+    std::ofstream(path, std::ios::trunc) << R"({"data":[[1,2)";
+    EXPECT_FALSE(loaded.loadData(path));
+    EXPECT_EQ(loaded.sampleCount(), 6u);
+    std::remove(path.c_str());
+    EXPECT_FALSE(loaded.loadData(path));
+}
+
+TEST(ApiHandlerTest, UnknownRoute) {
+    ApiHandler handler;
+    json response = json::parse(handler.handleRequest("/missing", "{}"));
+    EXPECT_EQ(response["success"], false);
+    EXPECT_EQ(response["error"], "路由不存在: /missing");
+}
+
+} // namespace
+} // namespace QualityManagement
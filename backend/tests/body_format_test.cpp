@@ -0,0 +1,77 @@
+#include "../include/body_format.h"
+#include <gtest/gtest.h>
+
+namespace QualityManagement {
+namespace {
+
+using json = nlohmann::json;
+
+json sampleValue() {
+    return json{
+        {"success", true},
+        {"message", "数据导入成功"},
+        {"count", 3},
+        {"negative", -17},
+        {"mean", 10.25},
+        {"ratio", 0.1},
+        {"data", json::array({json::array({1.5, 2.0, -3.25}), json::array({1e300, 4.9e-324})})},
+        {"empty", json::object()},
+        {"missing", nullptr},
+    };
+}
+
+TEST(BodyFormatTest, RoundTripsEveryFormat) {
+    json value = sampleValue();
+    for (BodyFormat format : {BodyFormat::Json, BodyFormat::Cbor, BodyFormat::MessagePack}) {
+        std::string encoded = encodeValue(value, format);
+        EXPECT_EQ(decodeBody(encoded, format), value) << mediaType(format);
+    }
+}
+
+TEST(BodyFormatTest, EncodesWithLibrarySerializers) {
+    json value = sampleValue();
+    EXPECT_EQ(encodeValue(value, BodyFormat::Json), value.dump());
+
+    std::vector<uint8_t> cbor = json::to_cbor(value);
+    EXPECT_EQ(encodeValue(value, BodyFormat::Cbor), std::string(cbor.begin(), cbor.end()));
+
+    std::vector<uint8_t> msgpack = json::to_msgpack(value);
+    EXPECT_EQ(encodeValue(value, BodyFormat::MessagePack), std::string(msgpack.begin(), msgpack.end()));
+}
+
+TEST(BodyFormatTest, EmptyBodyIsEmptyObject) {
+    for (BodyFormat format : {BodyFormat::Json, BodyFormat::Cbor, BodyFormat::MessagePack}) {
+        EXPECT_EQ(decodeBody("", format), json::object());
+    }
+}
+
+TEST(BodyFormatTest, MalformedBodyThrows) {
+    EXPECT_THROW(decodeBody("{\"data\":", BodyFormat::Json), json::exception);
+    EXPECT_THROW(decodeBody(std::string(1, '\xbf'), BodyFormat::Cbor), json::exception);
+    EXPECT_THROW(decodeBody(std::string(1, '\xc1'), BodyFormat::MessagePack), json::exception);
+}
+
+TEST(BodyFormatTest, RequestFormatFromContentType) {
+    EXPECT_EQ(requestBodyFormat(""), BodyFormat::Json);
+    EXPECT_EQ(requestBodyFormat("application/json; charset=utf-8"), BodyFormat::Json);
+    EXPECT_EQ(requestBodyFormat("Application/CBOR"), BodyFormat::Cbor);
+    EXPECT_EQ(requestBodyFormat("application/msgpack"), BodyFormat::MessagePack);
+    EXPECT_EQ(requestBodyFormat("application/x-msgpack"), BodyFormat::MessagePack);
+    EXPECT_EQ(requestBodyFormat("text/plain"), BodyFormat::Json);
+}
+
+TEST(BodyFormatTest, NegotiatesResponseFormat) {
+    EXPECT_EQ(negotiateBodyFormat(""), BodyFormat::Json);
+    EXPECT_EQ(negotiateBodyFormat("*/*"), BodyFormat::Json);
+    EXPECT_EQ(negotiateBodyFormat("application/cbor"), BodyFormat::Cbor);
+    EXPECT_EQ(negotiateBodyFormat("application/vnd.msgpack"), BodyFormat::MessagePack);
+    EXPECT_EQ(negotiateBodyFormat("application/json, application/cbor;q=0.5"), BodyFormat::Json);
+    EXPECT_EQ(negotiateBodyFormat("application/json;q=0.5, application/msgpack"), BodyFormat::MessagePack);
+    EXPECT_EQ(negotiateBodyFormat("application/msgpack, application/cbor"), BodyFormat::Cbor);
+    EXPECT_STREQ(mediaType(BodyFormat::Cbor), "application/cbor");
+    EXPECT_STREQ(mediaType(BodyFormat::MessagePack), "application/msgpack");
+    EXPECT_STREQ(mediaType(BodyFormat::Json), "application/json");
+}
+
+} // namespace
+} // namespace QualityManagement
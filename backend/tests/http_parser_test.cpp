@@ -0,0 +1,147 @@
+#include "../include/http_parser.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace QualityManagement {
+namespace {
+
+const size_t kMaxBody = 1024;
+
+TEST(HttpParserTest, ParsesRequestWithBody) {
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    std::string data = "POST /mean-test HTTP/1.1\r\nHost: x\r\nContent-Type: application/json\r\n"
+                       "Accept: application/cbor\r\nContent-Length: 4\r\n\r\n{\"a\"";
+    ASSERT_EQ(parser.parse(data, request), ParseStatus::Complete);
+    EXPECT_EQ(request.method, "POST");
+    EXPECT_EQ(request.path, "/mean-test");
+    EXPECT_EQ(request.version, "HTTP/1.1");
+    EXPECT_EQ(request.contentType, "application/json");
+    EXPECT_EQ(request.accept, "application/cbor");
+    EXPECT_EQ(request.body, "{\"a\"");
+    EXPECT_TRUE(request.keepAlive);
+    EXPECT_EQ(parser.requestLength(), data.size());
+}
+
+TEST(HttpParserTest, ResumesAcrossPartialReads) {
+    // 每次只多到达一个字节，解析结果与一次到齐相同
+    std::string data = "POST /all-analysis HTTP/1.1\r\nContent-Length: 2\r\nConnection: close\r\n\r\n{}";
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    for (size_t size = 1; size < data.size(); ++size) {
+        ASSERT_EQ(parser.parse(std::string_view(data).substr(0, size), request), ParseStatus::Incomplete) << size;
+    }
+    ASSERT_EQ(parser.parse(data, request), ParseStatus::Complete);
+    EXPECT_EQ(request.path, "/all-analysis");
+    EXPECT_EQ(request.body, "{}");
+    EXPECT_FALSE(request.keepAlive);
+}
+
+TEST(HttpParserTest, SeparatesPipelinedRequests) {
+    std::string data = "POST /a HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc"
+                       "GET /health HTTP/1.1\r\n\r\n"
+                       "POST /b HTTP/1.1\r\nContent-Length: 1\r\n\r\nx";
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    std::string_view rest = data;
+
+    ASSERT_EQ(parser.parse(rest, request), ParseStatus::Complete);
+    EXPECT_EQ(request.path, "/a");
+    EXPECT_EQ(request.body, "abc");
+    rest.remove_prefix(parser.requestLength());
+    parser.reset();
+
+    ASSERT_EQ(parser.parse(rest, request), ParseStatus::Complete);
+    EXPECT_EQ(request.method, "GET");
+    EXPECT_EQ(request.path, "/health");
+    EXPECT_TRUE(request.body.empty());
+    rest.remove_prefix(parser.requestLength());
+    parser.reset();
+
+    ASSERT_EQ(parser.parse(rest, request), ParseStatus::Complete);
+    EXPECT_EQ(request.path, "/b");
+    EXPECT_EQ(request.body, "x");
+    EXPECT_EQ(parser.requestLength(), rest.size());
+}
+
+TEST(HttpParserTest, ToleratesBlankLinesBetweenRequests) {
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    ASSERT_EQ(parser.parse("\r\n\r\nGET /ready HTTP/1.1\r\n\r\n", request), ParseStatus::Complete);
+    EXPECT_EQ(request.path, "/ready");
+}
+
+TEST(HttpParserTest, Http10DefaultsToClose) {
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    ASSERT_EQ(parser.parse("GET /health HTTP/1.0\r\n\r\n", request), ParseStatus::Complete);
+    EXPECT_FALSE(request.keepAlive);
+}
+
+TEST(HttpParserTest, RejectsDuplicateContentLength) {
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    EXPECT_EQ(parser.parse("POST /a HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 1\r\n\r\nx", request),
+              ParseStatus::Error);
+    EXPECT_STREQ(parser.errorStatus(), "400 Bad Request");
+
+    HttpParser conflicting(kMaxBody);
+    EXPECT_EQ(conflicting.parse("POST /a HTTP/1.1\r\nContent-Length: 1\r\ncontent-length: 2\r\n\r\nxy", request),
+              ParseStatus::Error);
+    EXPECT_STREQ(conflicting.errorStatus(), "400 Bad Request");
+}
+
+TEST(HttpParserTest, RejectsInvalidContentLength) {
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    EXPECT_EQ(parser.parse("POST /a HTTP/1.1\r\nContent-Length: 1x\r\n\r\n", request), ParseStatus::Error);
+    EXPECT_STREQ(parser.errorStatus(), "400 Bad Request");
+}
+
+TEST(HttpParserTest, RejectsOversizedBody) {
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    std::string data = "POST /a HTTP/1.1\r\nContent-Length: " + std::to_string(kMaxBody + 1) + "\r\n\r\n";
+    EXPECT_EQ(parser.parse(data, request), ParseStatus::Error);
+    EXPECT_STREQ(parser.errorStatus(), "413 Payload Too Large");
+}
+
+TEST(HttpParserTest, RejectsChunkedRequestBody) {
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    EXPECT_EQ(parser.parse("POST /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n", request), ParseStatus::Error);
+    EXPECT_STREQ(parser.errorStatus(), "501 Not Implemented");
+}
+
+TEST(HttpParserTest, RejectsUnsupportedVersion) {
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    EXPECT_EQ(parser.parse("GET / HTTP/2.0\r\n\r\n", request), ParseStatus::Error);
+    EXPECT_STREQ(parser.errorStatus(), "505 HTTP Version Not Supported");
+}
+
+TEST(HttpParserTest, LimitsHeaderSizeWhenLinesArriveWhole) {
+    // 客户端每次恰好发送完整的行，请求头累计超过上限时同样拒绝
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    std::string data = "GET / HTTP/1.1\r\n";
+    std::string line = "X-Filler: " + std::string(1000, 'a') + "\r\n";
+    ParseStatus status = ParseStatus::Incomplete;
+    while (status == ParseStatus::Incomplete && data.size() < 128 * 1024) {
+        data += line;
+        status = parser.parse(data, request);
+    }
+    EXPECT_EQ(status, ParseStatus::Error);
+    EXPECT_STREQ(parser.errorStatus(), "431 Request Header Fields Too Large");
+}
+
+TEST(HttpParserTest, LimitsHeaderSizeWithoutNewline) {
+    HttpParser parser(kMaxBody);
+    HttpRequest request;
+    std::string data = "GET /" + std::string(70 * 1024, 'a');
+    EXPECT_EQ(parser.parse(data, request), ParseStatus::Error);
+    EXPECT_STREQ(parser.errorStatus(), "431 Request Header Fields Too Large");
+}
+
+} // namespace
+} // namespace QualityManagement
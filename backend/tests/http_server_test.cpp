@@ -0,0 +1,146 @@
+#include "../include/http_server.h"
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+namespace QualityManagement {
+namespace {
+
+// 在进程内启动服务器，经Unix域套接字连接；TCP端口为0，由内核分配，测试之间不会冲突
+class ServerTest : public ::testing::TestWithParam<IoBackend> {
+protected:
+    void SetUp() override {
+        options_.port = 0;
+        options_.bindAddress = "127.0.0.1";
+        options_.unixSocketPath = ::testing::TempDir() + "qms_server_test.sock";
+        options_.ioThreads = 1;
+        options_.workerThreads = 2;
+        options_.ioBackend = GetParam();
+    }
+
+    void TearDown() override {
+        if (server_) {
+            server_->stop();
+        }
+    }
+
+    void startServer() {
+        server_ = std::make_unique<HttpServer>(api_, options_);
+        ASSERT_TRUE(server_->start());
+    }
+
+    int connectClient() {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, options_.unixSocketPath.c_str(), options_.unixSocketPath.size() + 1);
+        EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+        timeval timeout{10, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        return fd;
+    }
+
+    // 发送全部数据，对端已关闭时返回false
+    static bool sendAll(int fd, std::string_view data) {
+        while (!data.empty()) {
+            ssize_t sent = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data.remove_prefix(static_cast<size_t>(sent));
+        }
+        return true;
+    }
+
+    // 读取到连接关闭（或超时）为止
+    static std::string readAll(int fd) {
+        std::string data;
+        char buffer[65536];
+        ssize_t received;
+        while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            data.append(buffer, static_cast<size_t>(received));
+        }
+        return data;
+    }
+
+    static std::string post(const std::string& path, const std::string& body, bool keepAlive = false) {
+        return "POST " + path + " HTTP/1.1\r\nHost: test\r\nContent-Type: application/json\r\nContent-Length: " +
+               std::to_string(body.size()) + "\r\n" + (keepAlive ? "" : "Connection: close\r\n") + "\r\n" + body;
+    }
+
+    std::string roundTrip(const std::string& request) {
+        int fd = connectClient();
+        EXPECT_TRUE(sendAll(fd, request));
+        std::string response = readAll(fd);
+        close(fd);
+        return response;
+    }
+
+    ApiHandler api_;
+    ServerOptions options_;
+    std::unique_ptr<HttpServer> server_;
+};
+
+TEST_P(ServerTest, HeaderFloodIsRejectedEarly) {
+    // 客户端不停发送请求头行：服务器在超过请求头上限后就回复431并关闭，
+    // 不会先把客户端发来的全部数据读进内存
+    startServer();
+    int fd = connectClient();
+    std::string line = "X-Filler: " + std::string(1000, 'a') + "\r\n";
+    std::string flood = "GET /health HTTP/1.1\r\n";
+    while (flood.size() < 256 * 1024) {
+        flood += line;
+    }
+    size_t sent = 0;
+    for (int i = 0; i < 64 && sendAll(fd, flood); ++i) {
+        sent += flood.size();
+    }
+    std::string response = readAll(fd);
+    close(fd);
+    EXPECT_EQ(response.compare(0, 44, "HTTP/1.1 431 Request Header Fields Too Large"), 0) << response.substr(0, 200);
+    EXPECT_LT(sent, 64 * flood.size());
+}
+
+TEST_P(ServerTest, PipelinedRequestsAfterComputedResponse) {
+    startServer();
+    std::string request = post("/generate-data", R"({"groups":5,"samplesPerGroup":5})", true) +
+                          post("/descriptive-stats", "{}", true) + post("/mean-test", "{}", false);
+    std::string response = roundTrip(request);
+    size_t count = 0;
+    for (size_t pos = 0; (pos = response.find("HTTP/1.1 200 OK", pos)) != std::string::npos; ++pos) {
+        ++count;
+    }
+    EXPECT_EQ(count, 3u) << response.substr(0, 300);
+}
+
+TEST_P(ServerTest, StreamingRouteIsNotCoalesced) {
+    // 合并开启时流式接口仍以分块传输边生成边发送
+    options_.coalesceRequests = true;
+    startServer();
+    ASSERT_NE(roundTrip(post("/generate-data", R"({"groups":20,"samplesPerGroup":5})")).find("200 OK"),
+              std::string::npos);
+    std::string response = roundTrip(post("/all-analysis", "{}"));
+    EXPECT_EQ(response.compare(0, 15, "HTTP/1.1 200 OK"), 0) << response.substr(0, 200);
+    size_t headerEnd = response.find("\r\n\r\n");
+    ASSERT_NE(headerEnd, std::string::npos);
+    EXPECT_NE(response.substr(0, headerEnd).find("Transfer-Encoding: chunked"), std::string::npos)
+        << response.substr(0, headerEnd);
+    EXPECT_EQ(response.substr(response.size() - 5), "0\r\n\r\n");
+}
+
+INSTANTIATE_TEST_SUITE_P(IoBackends, ServerTest, ::testing::Values(IoBackend::Epoll, IoBackend::IoUring),
+                         [](const ::testing::TestParamInfo<IoBackend>& info) {
+                             return info.param == IoBackend::Epoll ? "Epoll" : "IoUring";
+                         });
+
+} // namespace
+} // namespace QualityManagement
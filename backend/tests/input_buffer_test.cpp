@@ -0,0 +1,75 @@
+#include "../include/input_buffer.h"
+#include "../include/http_parser.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+namespace QualityManagement {
+namespace {
+
+void append(InputBuffer& buffer, std::string_view data, size_t chunkSize) {
+    while (!data.empty()) {
+        size_t count = std::min(chunkSize, data.size());
+        std::memcpy(buffer.prepare(count), data.data(), count);
+        buffer.commit(count);
+        data.remove_prefix(count);
+    }
+}
+
+TEST(InputBufferTest, KeepsDataAcrossGrowthAndConsume) {
+    InputBuffer buffer;
+    std::string data;
+    for (int i = 0; i < 10000; ++i) {
+        data += std::to_string(i) + ',';
+    }
+    append(buffer, data, 1000);
+    EXPECT_EQ(buffer.readable(), data);
+
+    buffer.consume(100);
+    EXPECT_EQ(buffer.readable(), std::string_view(data).substr(100));
+
+    // 扩容时只保留未消费的数据
+    buffer.reserve(1 << 20);
+    EXPECT_GE(buffer.writable(), (1u << 20) - buffer.size());
+    EXPECT_EQ(buffer.readable(), std::string_view(data).substr(100));
+
+    buffer.consume(buffer.size());
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST(InputBufferTest, ParsesPipelinedRequestsInPlace) {
+    // 请求分多次到达缓冲，解析器在缓冲上逐个取出请求，请求体引用缓冲中的数据
+    std::string data;
+    for (int i = 0; i < 50; ++i) {
+        std::string body = "{\"i\":" + std::to_string(i) + "}";
+        data += "POST /r" + std::to_string(i) + " HTTP/1.1\r\nContent-Length: " + std::to_string(body.size()) +
+                "\r\n\r\n" + body;
+    }
+
+    InputBuffer buffer;
+    HttpParser parser(1024);
+    HttpRequest request;
+    int parsed = 0;
+    std::string_view rest = data;
+    while (!rest.empty()) {
+        size_t count = std::min<size_t>(7, rest.size());
+        append(buffer, rest.substr(0, count), count);
+        rest.remove_prefix(count);
+
+        ParseStatus status;
+        while ((status = parser.parse(buffer.readable(), request)) == ParseStatus::Complete) {
+            EXPECT_EQ(request.path, "/r" + std::to_string(parsed));
+            EXPECT_EQ(request.body, "{\"i\":" + std::to_string(parsed) + "}");
+            EXPECT_GE(request.body.data(), buffer.readable().data());
+            ++parsed;
+            buffer.consume(parser.requestLength());
+            parser.reset();
+        }
+        ASSERT_EQ(status, ParseStatus::Incomplete);
+    }
+    EXPECT_EQ(parsed, 50);
+    EXPECT_TRUE(buffer.empty());
+}
+
+} // namespace
+} // namespace QualityManagement
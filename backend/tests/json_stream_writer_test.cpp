@@ -0,0 +1,247 @@
+#include "../include/json_stream_writer.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace QualityManagement {
+namespace {
+
+using json = nlohmann::json;
+
+// 记录每次写出的分段
+class RecordingSink : public ResponseSink {
+public:
+    bool write(std::string chunk) override {
+        chunks.push_back(std::move(chunk));
+        return true;
+    }
+
+    std::string joined() const {
+        std::string data;
+        for (const auto& chunk : chunks) {
+            data += chunk;
+        }
+        return data;
+    }
+
+    std::vector<std::string> chunks;
+};
+
+std::string writeNumbers(const std::vector<double>& values, BodyFormat format = BodyFormat::Json) {
+    StringSink sink;
+    JsonStreamWriter writer(sink, format);
+    writer.beginArray(values.size());
+    for (double value : values) {
+        writer.number(value);
+    }
+    writer.endArray();
+    writer.flush();
+    return sink.take();
+}
+
+std::string writeIntegers(const std::vector<int64_t>& values, BodyFormat format = BodyFormat::Json) {
+    StringSink sink;
+    JsonStreamWriter writer(sink, format);
+    writer.beginArray(values.size());
+    for (int64_t value : values) {
+        writer.number(value);
+    }
+    writer.endArray();
+    writer.flush();
+    return sink.take();
+}
+
+// 按成员个数已知的方式写出一个典型的分析结果
+void writeResult(JsonStreamWriter& writer, const std::vector<double>& samples, size_t objectCount) {
+    writer.beginObject(objectCount);
+    writer.key("count").number(int64_t(3));
+    writer.key("data").numberArray(samples);
+    writer.key("indices").indexArray({0, 2, 300});
+    writer.key("message").string("数据\"导入\"成功\n");
+    writer.key("nested").beginObject(objectCount == JsonStreamWriter::kUnknownCount ? objectCount : 1);
+    writer.key("mean").number(10.25);
+    writer.endObject();
+    writer.key("success").boolean(true);
+    writer.key("value").value(json{{"a", nullptr}});
+    writer.endObject();
+}
+
+json expectedResult(const std::vector<double>& samples) {
+    return json{
+        {"count", 3},
+        {"data", samples},
+        {"indices", {0, 2, 300}},
+        {"message", "数据\"导入\"成功\n"},
+        {"nested", {{"mean", 10.25}}},
+        {"success", true},
+        {"value", {{"a", nullptr}}},
+    };
+}
+
+const std::vector<double> kNonFinite = {std::numeric_limits<double>::infinity(),
+                                        -std::numeric_limits<double>::infinity(),
+                                        std::numeric_limits<double>::quiet_NaN()};
+
+const std::vector<int64_t> kIntegers = {0, 1, -1, 23, 24, -24, -25, 255, 256, 65535, 65536, -129, 4294967296LL,
+                                        std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+
+// 这些值的最短往返表示与nlohmann::json::dump的输出逐字相同
+const std::vector<double> kFixedDoubles = {
+    0.0, -0.0, 1.0, -1.0, 1.5, 0.1, 0.2, 0.3, 1.0 / 3.0, 2.0 / 3.0, 3.141592653589793,
+    10.25, -273.15, 100.0, 123456789.0, 1e15, 1e16, 1e17, 1.5e17, 1e21, 1e22, 1e100, 1e300,
+    1e-5, 1e-6, 1e-7, 2.5e-5, 1.7976931348623157e308, 2.2250738585072014e-308, 5e-324,
+    9007199254740993.0, 0.000123456, 98.76543210123,
+};
+
+TEST(JsonStreamWriterTest, DoublesMatchJsonDump) {
+    for (double value : kFixedDoubles) {
+        EXPECT_EQ(writeNumbers({value}), json::array({value}).dump()) << value;
+    }
+}
+
+TEST(JsonStreamWriterTest, RandomDoublesRoundTrip) {
+    // 最短表示的位数可能与nlohmann的grisu2不同，但解析回来必须是同一个值
+    std::mt19937_64 random(12345);
+    std::uniform_int_distribution<int> exponent(-300, 300);
+    std::uniform_real_distribution<double> mantissa(-10.0, 10.0);
+    std::vector<double> values;
+    for (int i = 0; i < 2000; ++i) {
+        values.push_back(mantissa(random) * std::pow(10.0, exponent(random)));
+    }
+    for (int i = 0; i < 2000; ++i) {
+        uint64_t bits = random();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (std::isfinite(value)) {
+            values.push_back(value);
+        }
+    }
+
+    json parsed = json::parse(writeNumbers(values));
+    ASSERT_EQ(parsed.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(parsed[i].get<double>(), values[i]) << i;
+    }
+}
+
+TEST(JsonStreamWriterTest, NonFiniteIsNull) {
+    EXPECT_EQ(writeNumbers(kNonFinite), "[null,null,null]");
+}
+
+TEST(JsonStreamWriterTest, IntegersMatchJsonDump) {
+    EXPECT_EQ(writeIntegers(kIntegers), json(kIntegers).dump());
+}
+
+TEST(JsonStreamWriterTest, StructureMatchesJsonDump) {
+    std::vector<double> samples = {1.5, 0.1, -3.0, 1e300, 65504.0, 1e-40};
+    StringSink sink;
+    JsonStreamWriter writer(sink);
+    writeResult(writer, samples, 7);
+    writer.flush();
+    EXPECT_EQ(sink.take(), expectedResult(samples).dump());
+}
+
+TEST(JsonStreamWriterTest, CountMismatchThrows) {
+    StringSink sink;
+    JsonStreamWriter writer(sink);
+    writer.beginArray(2).number(1.0);
+    EXPECT_THROW(writer.endArray(), std::logic_error);
+
+    StringSink objectSink;
+    JsonStreamWriter object(objectSink);
+    object.beginObject(1).key("a").number(1.0).key("b");
+    EXPECT_THROW(object.number(2.0).endObject(), std::logic_error);
+}
+
+TEST(JsonStreamWriterTest, LargeArraysAreWrittenInChunks) {
+    std::vector<double> samples(100000);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<double>(i) / 7.0;
+    }
+    RecordingSink sink;
+    JsonStreamWriter writer(sink);
+    writer.numberArray(samples);
+    writer.flush();
+    EXPECT_GT(sink.chunks.size(), 1u);
+    EXPECT_EQ(json::parse(sink.joined()), json(samples));
+}
+
+// 二进制格式
+
+std::string bytes(const std::vector<uint8_t>& data) {
+    return std::string(data.begin(), data.end());
+}
+
+TEST(JsonStreamWriterBinaryTest, ScalarsMatchLibraryEncoders) {
+    json nulls = json::array({nullptr, nullptr, nullptr});
+    std::vector<double> doubles = {1.5, 0.1, 65504.0, 1e300, -0.0, 1e-40};
+    EXPECT_EQ(writeNumbers(kNonFinite, BodyFormat::Cbor), bytes(json::to_cbor(nulls)));
+    EXPECT_EQ(writeNumbers(kNonFinite, BodyFormat::MessagePack), bytes(json::to_msgpack(nulls)));
+    EXPECT_EQ(writeIntegers(kIntegers, BodyFormat::Cbor), bytes(json::to_cbor(kIntegers)));
+    EXPECT_EQ(writeIntegers(kIntegers, BodyFormat::MessagePack), bytes(json::to_msgpack(kIntegers)));
+    // 能精确表示为单精度的值按单精度编码，与to_cbor/to_msgpack相同
+    EXPECT_EQ(writeNumbers(doubles, BodyFormat::Cbor), bytes(json::to_cbor(doubles)));
+    EXPECT_EQ(writeNumbers(doubles, BodyFormat::MessagePack), bytes(json::to_msgpack(doubles)));
+}
+
+TEST(JsonStreamWriterBinaryTest, StructureMatchesLibraryEncoders) {
+    std::vector<double> samples = {1.5, 0.1, -3.0, 1e300, 65504.0, 1e-40};
+    json expected = expectedResult(samples);
+    for (BodyFormat format : {BodyFormat::Cbor, BodyFormat::MessagePack}) {
+        StringSink sink;
+        JsonStreamWriter writer(sink, format);
+        writeResult(writer, samples, 7);
+        writer.flush();
+        EXPECT_EQ(sink.take(), encodeValue(expected, format)) << mediaType(format);
+    }
+}
+
+TEST(JsonStreamWriterBinaryTest, UnknownCountObjects) {
+    std::vector<double> samples = {1.5, 2.5};
+    json expected = expectedResult(samples);
+
+    // MessagePack在对象结束时改写映射头，结果与to_msgpack逐字节相同
+    StringSink msgpackSink;
+    JsonStreamWriter msgpack(msgpackSink, BodyFormat::MessagePack);
+    writeResult(msgpack, samples, JsonStreamWriter::kUnknownCount);
+    msgpack.flush();
+    EXPECT_EQ(msgpackSink.take(), bytes(json::to_msgpack(expected)));
+
+    // CBOR输出不定长映射，解码后相同
+    StringSink cborSink;
+    JsonStreamWriter cbor(cborSink, BodyFormat::Cbor);
+    writeResult(cbor, samples, JsonStreamWriter::kUnknownCount);
+    cbor.flush();
+    std::string encoded = cborSink.take();
+    ASSERT_FALSE(encoded.empty());
+    EXPECT_EQ(static_cast<uint8_t>(encoded.front()), 0xbf);
+    EXPECT_EQ(static_cast<uint8_t>(encoded.back()), 0xff);
+    EXPECT_EQ(json::from_cbor(encoded), expected);
+}
+
+TEST(JsonStreamWriterBinaryTest, RawRequiresJson) {
+    StringSink sink;
+    JsonStreamWriter writer(sink, BodyFormat::Cbor);
+    EXPECT_THROW(writer.raw("{}"), std::logic_error);
+}
+
+TEST(JsonStreamWriterBinaryTest, LargeArraysAreWrittenInChunks) {
+    std::vector<double> samples(100000);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<double>(i) / 7.0;
+    }
+    for (BodyFormat format : {BodyFormat::Cbor, BodyFormat::MessagePack}) {
+        RecordingSink sink;
+        JsonStreamWriter writer(sink, format);
+        writer.numberArray(samples);
+        writer.flush();
+        EXPECT_GT(sink.chunks.size(), 1u) << mediaType(format);
+        EXPECT_EQ(decodeBody(sink.joined(), format), json(samples)) << mediaType(format);
+    }
+}
+
+} // namespace
+} // namespace QualityManagement
@@ -0,0 +1,93 @@
+#include "../include/rate_limiter.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace QualityManagement {
+namespace {
+
+TEST(RateLimiterTest, DisabledWhenRateIsZero) {
+    RateLimiter limiter(0, 1);
+    EXPECT_FALSE(limiter.enabled());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(limiter.tryConsume(1, 10), 0);
+    }
+    EXPECT_EQ(limiter.throttledCount(), 0u);
+}
+
+TEST(RateLimiterTest, AllowsBurstThenThrottles) {
+    RateLimiter limiter(1, 5);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(limiter.tryConsume(42, 1), 0) << i;
+    }
+    int retryAfter = limiter.tryConsume(42, 1);
+    EXPECT_GE(retryAfter, 1);
+    EXPECT_LE(retryAfter, 60);
+    EXPECT_EQ(limiter.throttledCount(), 1u);
+}
+
+TEST(RateLimiterTest, ClientsHaveSeparateBuckets) {
+    RateLimiter limiter(1, 2);
+    EXPECT_EQ(limiter.tryConsume(1, 2), 0);
+    EXPECT_NE(limiter.tryConsume(1, 1), 0);
+    EXPECT_EQ(limiter.tryConsume(2, 2), 0);
+}
+
+TEST(RateLimiterTest, RefillsOverTime) {
+    // 每秒补充100个令牌，即每10毫秒一个
+    RateLimiter limiter(100, 2);
+    EXPECT_EQ(limiter.tryConsume(9, 2), 0);
+    EXPECT_NE(limiter.tryConsume(9, 1), 0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(limiter.tryConsume(9, 2), 0);
+}
+
+TEST(RateLimiterTest, RefillIsCappedAtBurst) {
+    RateLimiter limiter(1000, 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(limiter.tryConsume(5, 3), 0);
+    EXPECT_NE(limiter.tryConsume(5, 3), 0);
+}
+
+TEST(RateLimiterTest, CostAboveBurstIsClamped) {
+    // 单次请求的代价超过桶容量时按容量扣除，满桶的客户端仍能放行
+    RateLimiter limiter(1, 2);
+    EXPECT_EQ(limiter.tryConsume(3, 10), 0);
+    EXPECT_NE(limiter.tryConsume(3, 10), 0);
+}
+
+TEST(RateLimiterTest, ConcurrentRecyclingKeepsBucketsSeparate) {
+    // 两个位置、每毫秒补满，不断有新客户端回收空闲的桶。每个客户端只请求一次，
+    // 桶容量为1：若两个客户端在同一个桶上扣除，其中一个会被误拒
+    RateLimiter limiter(1000000, 1, 2);
+    std::atomic<uint64_t> nextKey{1};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 20000; ++i) {
+                limiter.tryConsume(nextKey.fetch_add(1), 1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(limiter.throttledCount(), 0u);
+}
+
+TEST(RateLimiterTest, EndpointCost) {
+    EXPECT_EQ(RateLimiter::endpointCost("/all-analysis"), 10u);
+    EXPECT_EQ(RateLimiter::endpointCost("/import-data"), 5u);
+    EXPECT_EQ(RateLimiter::endpointCost("/append-data"), 5u);
+    EXPECT_EQ(RateLimiter::endpointCost("/generate-data"), 2u);
+    EXPECT_EQ(RateLimiter::endpointCost("/jobs/all-analysis"), 10u);
+    EXPECT_EQ(RateLimiter::endpointCost("/jobs/append-data"), 5u);
+    EXPECT_EQ(RateLimiter::endpointCost("/health"), 1u);
+    EXPECT_EQ(RateLimiter::endpointCost("/jobs"), 1u);
+}
+
+} // namespace
+} // namespace QualityManagement
@@ -0,0 +1,112 @@
+#include "../include/server_config.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace QualityManagement {
+namespace {
+
+// 按命令行参数加载配置；测试之间清理用到的环境变量
+ConfigStatus load(std::vector<std::string> arguments, RuntimeConfig& config) {
+    arguments.insert(arguments.begin(), "quality_management_server");
+    std::vector<char*> argv;
+    for (auto& argument : arguments) {
+        argv.push_back(&argument[0]);
+    }
+    argv.push_back(nullptr);
+    return loadRuntimeConfig(static_cast<int>(arguments.size()), argv.data(), config);
+}
+
+class ServerConfigTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        unsetenv("QMS_CONFIG");
+        unsetenv("QMS_PORT");
+        unsetenv("QMS_WORKER_THREADS");
+        if (!configPath_.empty()) {
+            std::remove(configPath_.c_str());
+        }
+    }
+
+    std::string writeConfig(const std::string& contents) {
+        configPath_ = ::testing::TempDir() + "qms_config_test.json";
+        std::ofstream(configPath_) << contents;
+        return configPath_;
+    }
+
+    std::string configPath_;
+};
+
+TEST_F(ServerConfigTest, DefaultsWithoutArguments) {
+    RuntimeConfig config;
+    ASSERT_EQ(load({}, config), ConfigStatus::Run);
+    ServerOptions defaults;
+    EXPECT_EQ(config.server.port, defaults.port);
+    EXPECT_EQ(config.server.coalesceRequests, defaults.coalesceRequests);
+    EXPECT_TRUE(config.stateFile.empty());
+}
+
+TEST_F(ServerConfigTest, ParsesCommandLine) {
+    RuntimeConfig config;
+    ASSERT_EQ(load({"--port", "9000", "--worker-threads=3", "--io-backend", "io_uring", "--reuseport",
+                    "--coalesce", "off", "--coalesce-wait-ms", "5000", "--max-body-mb", "2", "--state-file", "/tmp/state.json"}, config),
+              ConfigStatus::Run);
+    EXPECT_EQ(config.server.port, 9000);
+    EXPECT_EQ(config.server.workerThreads, 3);
+    EXPECT_EQ(config.server.ioBackend, IoBackend::IoUring);
+    EXPECT_TRUE(config.server.reusePort);
+    EXPECT_FALSE(config.server.coalesceRequests);
+    EXPECT_EQ(config.server.coalesceWaitMs, 5000);
+    EXPECT_EQ(config.server.maxBodySize, 2u * 1024 * 1024);
+    EXPECT_EQ(config.stateFile, "/tmp/state.json");
+}
+
+TEST_F(ServerConfigTest, RejectsInvalidValues) {
+    const std::vector<std::vector<std::string>> cases = {
+        {"--port", "0"},
+        {"--port", "70000"},
+        {"--port", "80x"},
+        {"--io-backend", "kqueue"},
+        {"--coalesce", "maybe"},
+        {"--no-such-option", "1"},
+        {"--port"},
+        {"positional"},
+    };
+    for (const auto& arguments : cases) {
+        RuntimeConfig config;
+        EXPECT_EQ(load(arguments, config), ConfigStatus::Invalid) << arguments.front();
+    }
+}
+
+TEST_F(ServerConfigTest, CommandLineOverridesEnvironmentOverridesFile) {
+    std::string path = writeConfig(R"({"port": 7000, "worker-threads": 5, "bind": "127.0.0.1"})");
+    setenv("QMS_PORT", "7100", 1);
+    setenv("QMS_WORKER_THREADS", "6", 1);
+
+    RuntimeConfig config;
+    ASSERT_EQ(load({"--config", path, "--worker-threads", "7"}, config), ConfigStatus::Run);
+    EXPECT_EQ(config.server.bindAddress, "127.0.0.1");
+    EXPECT_EQ(config.server.port, 7100);
+    EXPECT_EQ(config.server.workerThreads, 7);
+}
+
+TEST_F(ServerConfigTest, ConfigFileFromEnvironment) {
+    setenv("QMS_CONFIG", writeConfig(R"({"port": "7200"})").c_str(), 1);
+    RuntimeConfig config;
+    ASSERT_EQ(load({}, config), ConfigStatus::Run);
+    EXPECT_EQ(config.server.port, 7200);
+}
+
+TEST_F(ServerConfigTest, RejectsBadConfigFile) {
+    RuntimeConfig config;
+    EXPECT_EQ(load({"--config", writeConfig(R"({"unknown": 1})")}, config), ConfigStatus::Invalid);
+    EXPECT_EQ(load({"--config", writeConfig("[1, 2]")}, config), ConfigStatus::Invalid);
+    EXPECT_EQ(load({"--config", writeConfig(R"({"port": 0})")}, config), ConfigStatus::Invalid);
+    EXPECT_EQ(load({"--config", ::testing::TempDir() + "qms_missing_config.json"}, config), ConfigStatus::Invalid);
+}
+
+} // namespace
+} // namespace QualityManagement
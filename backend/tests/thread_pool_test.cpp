@@ -0,0 +1,60 @@
+#include "../include/thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace QualityManagement {
+namespace {
+
+using namespace std::chrono_literals;
+
+TEST(ThreadPoolTest, ShutdownForWaitsForRunningTasks) {
+    ThreadPool pool(2, 8);
+    std::atomic<int> done{0};
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(pool.trySubmit([&done] {
+            std::this_thread::sleep_for(20ms);
+            ++done;
+        }));
+    }
+    std::this_thread::sleep_for(5ms);
+    size_t discarded = 0;
+    EXPECT_TRUE(pool.shutdownFor(5000ms, discarded));
+    EXPECT_EQ(done.load(), 2);
+    EXPECT_FALSE(pool.trySubmit([] {}));
+}
+
+TEST(ThreadPoolTest, ShutdownForGivesUpOnStuckTask) {
+    // 超时后线程池必须保持存活，这里有意不释放
+    auto* pool = new ThreadPool(1, 8);
+    std::atomic<bool> release{false};
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+    ASSERT_TRUE(pool->trySubmit([&] {
+        started = true;
+        while (!release) {
+            std::this_thread::sleep_for(1ms);
+        }
+        finished = true;
+    }));
+    ASSERT_TRUE(pool->trySubmit([] {}));
+    while (!started) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    size_t discarded = 0;
+    EXPECT_FALSE(pool->shutdownFor(50ms, discarded));
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, 2s);
+    EXPECT_EQ(discarded, 1u);
+
+    // 让分离的线程在测试结束前退出
+    release = true;
+    while (!finished) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+} // namespace
+} // namespace QualityManagement
@@ -0,0 +1,122 @@
+#include "../include/timer_wheel.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace QualityManagement {
+namespace {
+
+// 时间轮按真实的单调时钟推进，测试中睡眠到期后再推进
+void sleepMs(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+std::vector<uint64_t> advanceKeys(TimerWheel& wheel) {
+    std::vector<uint64_t> keys;
+    wheel.advance([&keys](TimerNode& node) {
+        EXPECT_FALSE(node.scheduled());
+        keys.push_back(node.key);
+    });
+    return keys;
+}
+
+TEST(TimerWheelTest, FiresAfterDelay) {
+    TimerWheel wheel(1);
+    TimerNode node;
+    node.key = 7;
+    wheel.schedule(node, 20);
+    EXPECT_TRUE(node.scheduled());
+    EXPECT_FALSE(wheel.empty());
+
+    EXPECT_TRUE(advanceKeys(wheel).empty());
+    EXPECT_TRUE(node.scheduled());
+
+    sleepMs(30);
+    EXPECT_EQ(advanceKeys(wheel), std::vector<uint64_t>{7});
+    EXPECT_FALSE(node.scheduled());
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, CancelRemovesNode) {
+    TimerWheel wheel(1);
+    TimerNode kept;
+    TimerNode cancelled;
+    kept.key = 1;
+    cancelled.key = 2;
+    wheel.schedule(kept, 5);
+    wheel.schedule(cancelled, 5);
+
+    cancelled.cancel();
+    EXPECT_FALSE(cancelled.scheduled());
+    cancelled.cancel();
+
+    sleepMs(15);
+    EXPECT_EQ(advanceKeys(wheel), std::vector<uint64_t>{1});
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, DestructorCancels) {
+    TimerWheel wheel(1);
+    {
+        TimerNode node;
+        wheel.schedule(node, 5);
+        EXPECT_FALSE(wheel.empty());
+    }
+    EXPECT_TRUE(wheel.empty());
+    sleepMs(10);
+    EXPECT_TRUE(advanceKeys(wheel).empty());
+}
+
+TEST(TimerWheelTest, RescheduleReplacesPreviousDeadline) {
+    TimerWheel wheel(1);
+    TimerNode node;
+    node.key = 3;
+    wheel.schedule(node, 5);
+    wheel.schedule(node, 200);
+
+    sleepMs(20);
+    EXPECT_TRUE(advanceKeys(wheel).empty());
+    EXPECT_TRUE(node.scheduled());
+
+    wheel.schedule(node, 1);
+    sleepMs(10);
+    EXPECT_EQ(advanceKeys(wheel), std::vector<uint64_t>{3});
+}
+
+TEST(TimerWheelTest, CascadesFromHigherLevels) {
+    // 超过64个刻度的定时器先放在第1层，到期前下放到第0层；
+    // 每个定时器只在到期后触发一次，按到期先后回调。刻度从时间轮创建时起算，
+    // 与本测试的计时起点相差不到一个刻度
+    TimerWheel wheel(1);
+    const uint64_t delays[] = {150, 70, 10, 260};
+    TimerNode nodes[4];
+    for (int i = 0; i < 4; ++i) {
+        nodes[i].key = delays[i];
+        wheel.schedule(nodes[i], delays[i]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint64_t> fired;
+    while (!wheel.empty() && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+        sleepMs(2);
+        wheel.advance([&](TimerNode& node) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            EXPECT_GE(static_cast<uint64_t>(elapsed) + 1, node.key);
+            fired.push_back(node.key);
+        });
+    }
+    EXPECT_EQ(fired, (std::vector<uint64_t>{10, 70, 150, 260}));
+}
+
+TEST(TimerWheelTest, CoarseTickRoundsUp) {
+    TimerWheel wheel(10);
+    TimerNode node;
+    wheel.schedule(node, 1);
+    sleepMs(25);
+    EXPECT_EQ(advanceKeys(wheel).size(), 1u);
+}
+
+} // namespace
+} // namespace QualityManagement
@@ -1,4 +1,5 @@
 @echo off
+REM 后端只支持Linux（epoll/io_uring），Windows上通过Docker编译Linux二进制文件
 echo 开始交叉编译 Linux x86 二进制文件...
 
 REM 创建输出目录
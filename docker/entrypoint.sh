@@ -9,5 +9,11 @@ else
   echo "未设置PORT环境变量，使用默认端口80"
 fi
 
+# 后端与nginx同机部署时，通过Unix域套接字代理API请求
+if [ ! -z "$BACKEND_SOCKET" ]; then
+  sed -i.bak "s|server localhost:3001;|server unix:$BACKEND_SOCKET;|g" /etc/nginx/conf.d/default.conf
+  echo "Nginx 配置已更新，后端地址: unix:$BACKEND_SOCKET"
+fi
+
 # 启动 Nginx
 exec nginx -g 'daemon off;'
\ No newline at end of file
@@ -145,6 +145,17 @@ const Dashboard: React.FC = () => {
         }
     };
 
+    // 有分析结果后订阅控制图的实时更新，追加数据时不必重新请求完整控制图
+    const hasAnalysis = analysisResult !== null;
+    useEffect(() => {
+        if (!hasAnalysis) {
+            return;
+        }
+        return api.subscribeControlChart((controlChart) => {
+            setAnalysisResult(previous => previous ? { ...previous, controlChart } : previous);
+        });
+    }, [hasAnalysis]);
+
     // 执行完整分析
     const performFullAnalysis = async (lsl: number, usl: number, expectedMean: number) => {
         try {
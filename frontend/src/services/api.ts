@@ -340,6 +340,46 @@ export const generateControlChartData = async (): Promise<ApiResponse<ControlCha
     }
 };
 
+// 订阅控制图实时更新（Server-Sent Events）：连接时收到完整快照，
+// 之后每次追加数据只收到新子组和更新后的控制限；返回取消订阅的函数
+export const subscribeControlChart = (
+    onUpdate: (data: ControlChartData) => void
+): (() => void) => {
+    if (USE_MOCK_DATA || typeof EventSource === 'undefined') {
+        return () => {};
+    }
+
+    let current: ControlChartData | null = null;
+    const source = new EventSource(`${API_BASE_URL}/control-chart/stream`);
+
+    const apply = (event: MessageEvent, append: boolean) => {
+        const payload = JSON.parse(event.data);
+        if (payload.groups === 0) {
+            current = null;
+            return;
+        }
+        const means: number[] = append && current ? [...(current.means || []), ...payload.means] : payload.means;
+        const ranges: number[] = append && current ? [...(current.ranges || []), ...payload.ranges] : payload.ranges;
+        current = {
+            isControlled: payload.isControlled,
+            means,
+            ranges,
+            clMean: payload.clMean,
+            uclMean: payload.uclMean,
+            lclMean: payload.lclMean,
+            clRange: payload.clRange,
+            uclRange: payload.uclRange,
+            lclRange: payload.lclRange
+        };
+        onUpdate(current);
+    };
+
+    source.addEventListener('snapshot', (event) => apply(event as MessageEvent, false));
+    source.addEventListener('append', (event) => apply(event as MessageEvent, true));
+    // 断线后EventSource自动重连，服务器会重新发送快照
+    return () => source.close();
+};
+
 // 获取过程评估
 export const getProcessAssessment = async (
     lsl: number = 70,